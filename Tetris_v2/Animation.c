@@ -0,0 +1,146 @@
+/*
+ * @file Animation.c
+ * @author: JZimnol
+ * @brief File containing definitions for keyframe animations
+ */ 
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "Tetris.h"
+#include "Animation.h"
+#include "Game.h"
+#include "Display.h"
+#include "Bitmap.h"
+#include "Tick.h"
+
+/*************************************************************************\
+                                  TABLES
+\*************************************************************************/
+
+/* PLAY blinks in negative twice, as long as the old 250 tick pause */
+static const Keyframe startKeys[] PROGMEM = {
+    { KEY_BITMAP, BITMAP_AT(BITMAP_PLAY_INVERTED, FLOOR_TOP), 62 },
+    { KEY_BITMAP, BITMAP_AT(BITMAP_PLAY, FLOOR_TOP),          62 },
+    { KEY_BITMAP, BITMAP_AT(BITMAP_PLAY_INVERTED, FLOOR_TOP), 62 },
+    { KEY_BITMAP, BITMAP_AT(BITMAP_PLAY, FLOOR_TOP),          64 },
+    { KEY_END,    0,                                          0 }
+};
+
+/* ~100 ms plus 12 ms per cleared row */
+static const Keyframe lineClearKeys[] PROGMEM = {
+    { KEY_ROWS_SET, 0xc003, 32 },
+    { KEY_ROWS_SET, 0xffff, 32 },
+    { KEY_ROWS_SET, 0xc003, 32 },
+    { KEY_ROWS_SET, 0xffff, 32 },
+    { KEY_ROWS_AND, 0xfe7f, 12 },     /* wipe from the middle to the walls */
+    { KEY_ROWS_AND, 0xfc3f, 12 },
+    { KEY_ROWS_AND, 0xf81f, 12 },
+    { KEY_ROWS_AND, 0xf00f, 12 },
+    { KEY_ROWS_AND, 0xe007, 12 },
+    { KEY_ROWS_AND, 0xc003, 12 },
+    { KEY_COLLAPSE, 0,      24 },
+    { KEY_END,      0,      0 }
+};
+
+/* three flashes into GAME OVER, then OVER blinks (delta frames) */
+static const Keyframe gameOverKeys[] PROGMEM = {
+    { KEY_WAIT,   0,                             500 },
+    { KEY_FILL,   0xffff,                        500 },
+    { KEY_BITMAP, BITMAP_AT(BITMAP_GAME_OVER, 0), 500 },
+    { KEY_FILL,   0xffff,                        500 },
+    { KEY_BITMAP, BITMAP_AT(BITMAP_GAME_OVER, 0), 500 },
+    { KEY_FILL,   0xffff,                        500 },
+    { KEY_BITMAP, BITMAP_AT(BITMAP_GAME_OVER, 0), 500 },
+    { KEY_BITMAP, BITMAP_AT(BITMAP_OVER_OFF, 0),  500 },
+    { KEY_BITMAP, BITMAP_AT(BITMAP_OVER_ON, 0),   500 },
+    { KEY_BITMAP, BITMAP_AT(BITMAP_OVER_OFF, 0),  500 },
+    { KEY_BITMAP, BITMAP_AT(BITMAP_OVER_ON, 0),   500 },
+    { KEY_END,    0,                             0 }
+};
+
+/* indexed by AnimationId */
+static const Keyframe * const sequences[] PROGMEM = {
+    startKeys,
+    lineClearKeys,
+    gameOverKeys
+};
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static const Keyframe *animKey = NULL;  /* next keyframe (flash), NULL when idle */
+static uint32_t animRows;               /* rows selected for row operations */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/* remove the lowest selected row; the rows above it fall by one */
+static void collapseRow() {
+    uint8_t row = 31;
+
+    while( !(animRows & ((uint32_t)1<<row)) ) {
+        row--;
+    }
+    for( uint8_t i=row; i>FLOOR_TOP + 1; i-- ) {
+        frameBuffer.main[i] = frameBuffer.main[i - 1];
+    }
+    frameBuffer.main[FLOOR_TOP + 1] = 0xc003;
+    /* selected rows above it have moved down as well */
+    animRows = (animRows & (((uint32_t)1<<row) - 1)) << 1;
+}
+
+void animationStart(uint8_t id, uint32_t rows) {
+    animKey = pgm_read_ptr(&sequences[id]);
+    animRows = rows;
+    frameHeld = TRUE;
+    /* the first keyframe is played at once */
+    tickTimerStart(TIMER_ANIMATION, 0);
+    animationStep();
+}
+
+void animationStep() {
+    uint8_t op;
+    uint16_t value;
+
+    if( animKey == NULL || tickTimerExpired(TIMER_ANIMATION) == FALSE ) return;
+
+    op = pgm_read_byte(&animKey->op);
+    value = pgm_read_word(&animKey->value);
+    if( op == KEY_END ) {
+        animKey = NULL;
+        frameHeld = FALSE;
+        FRAME_CHANGED();            /* show the game state the animation covered */
+        gameEvent(EVENT_ANIMATION_DONE, 0);
+        return;
+    }
+
+    if( op == KEY_FILL ) {
+        for( uint8_t i=0; i<32; i++ ) {
+            frameBuffer.main[i] = value;
+        }
+    }
+    else if( op == KEY_ROWS_SET || op == KEY_ROWS_AND ) {
+        for( uint8_t i=0; i<32; i++ ) {
+            if( !(animRows & ((uint32_t)1<<i)) ) continue;
+            if( op == KEY_ROWS_SET ) frameBuffer.main[i] = value;
+            else frameBuffer.main[i] &= value;
+        }
+    }
+    else if( op == KEY_COLLAPSE ) {
+        if( animRows ) collapseRow();
+    }
+    else if( op == KEY_BITMAP ) {
+        bitmapDraw(value & 0xff, &frameBuffer.main[value>>8], 32 - (value>>8));
+    }
+
+    DISPLAY_FLUSH();
+    tickTimerStart(TIMER_ANIMATION, pgm_read_word(&animKey->ticks));
+    /* a collapse stays on its keyframe until every selected row is gone */
+    if( op != KEY_COLLAPSE || animRows == 0 ) animKey++;
+}
+
+uint8_t animationBusy() {
+    return animKey != NULL;
+}
@@ -0,0 +1,75 @@
+/*
+ * @file Animation.h
+ * @author: JZimnol
+ * @brief File containing non-blocking keyframe animations stored in flash
+ */ 
+
+
+#ifndef ANIMATION_H_
+#define ANIMATION_H_
+
+#include "Config.h"
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+/*
+ * @brief Keyframe value of KEY_BITMAP: bitmap id and the row it starts at
+ */
+#define BITMAP_AT(id, row)  ((uint16_t)(row)<<8 | (id))
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Operations of a keyframe. Row operations work on the rows passed
+ *        to animationStart(), always on frameBuffer.main.
+ */
+typedef enum {
+    KEY_END      = (uint8_t)0,    /* give the display back to the game */
+    KEY_WAIT     = (uint8_t)1,    /* keep the picture */
+    KEY_FILL     = (uint8_t)2,    /* every row = value */
+    KEY_ROWS_SET = (uint8_t)3,    /* selected rows = value */
+    KEY_ROWS_AND = (uint8_t)4,    /* selected rows &= value */
+    KEY_COLLAPSE = (uint8_t)5,    /* drop the lowest selected row, repeated until none is left */
+    KEY_BITMAP   = (uint8_t)6     /* value = BITMAP_AT(id, first row) */
+} KeyOp;
+/*
+ * @brief One step of a sequence; it is shown for the given number of ticks
+ */
+typedef struct {
+    uint8_t op;
+    uint16_t value;
+    uint16_t ticks;
+} Keyframe;
+/*
+ * @brief Sequences in flash
+ */
+typedef enum {
+    ANIM_START      = (uint8_t)0,    /* PLAY blinks after it was pushed */
+    ANIM_LINE_CLEAR = (uint8_t)1,    /* flash, wipe and collapse of the cleared rows */
+    ANIM_GAME_OVER  = (uint8_t)2     /* flashes and GAME OVER */
+} AnimationId;
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief start a sequence, replacing the one that is playing; the display
+ *        shows the animation until KEY_END, which reports EVENT_ANIMATION_DONE
+ * @param animation id and rows selected for row operations (bit n = row n)
+ */
+void animationStart(uint8_t id, uint32_t rows);
+/*
+ * @brief play the next keyframe when the current one has been shown long
+ *        enough; call from the animation task
+ */
+void animationStep();
+/*
+ * @brief check if a sequence is playing
+ * @return true or false
+ */
+uint8_t animationBusy();
+
+#endif /* ANIMATION_H_ */
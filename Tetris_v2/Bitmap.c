@@ -0,0 +1,95 @@
+/*
+ * @file Bitmap.c
+ * @author: JZimnol
+ * @brief File containing definitions for the compressed bitmaps
+ */ 
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "Tetris.h"
+#include "Bitmap.h"
+
+/*************************************************************************\
+                                  TABLES
+\*************************************************************************/
+
+/* generated by Tools/bitmap_encoder.py from Tools/bitmaps.txt */
+
+/* play: 25 rows, image, 16 bytes (50 raw) */
+static const uint8_t playBitmap[] PROGMEM = {
+    0x07, 0x46, 0xe8, 0xea, 0xa8, 0xaa, 0xe8, 0xe4, 0x88, 0xa4, 0x8e, 0xa4,
+    0x00, 0x00, 0x0c, 0x00,
+};
+
+/* play_inverted: 25 rows, image, 19 bytes (50 raw) */
+static const uint8_t playInvertedBitmap[] PROGMEM = {
+    0x41, 0xff, 0xff, 0x06, 0x46, 0x17, 0x15, 0x57, 0x55, 0x17, 0x1b, 0x77,
+    0x5b, 0x71, 0x5b, 0xff, 0xff, 0x0c, 0x00,
+};
+
+/* game_over: 32 rows, image, 30 bytes (64 raw) */
+static const uint8_t gameOverBitmap[] PROGMEM = {
+    0x0a, 0x46, 0xee, 0xae, 0x8a, 0xe8, 0xae, 0xee, 0xaa, 0xa8, 0xea, 0xae,
+    0x00, 0x00, 0x01, 0x46, 0xea, 0xee, 0xaa, 0x8a, 0xaa, 0xec, 0xaa, 0x8a,
+    0xe4, 0xea, 0x00, 0x00, 0x09, 0x00,
+};
+
+/* over_off: 32 rows, delta of game_over, 4 bytes (64 raw) */
+static const uint8_t overOffBitmap[] PROGMEM = {
+    0x91, 0x05, 0x8a, 0x00,
+};
+
+/* over_on: 32 rows, delta of over_off, 14 bytes (64 raw) */
+static const uint8_t overOnBitmap[] PROGMEM = {
+    0x91, 0x45, 0xea, 0xee, 0xaa, 0x8a, 0xaa, 0xec, 0xaa, 0x8a, 0xe4, 0xea,
+    0x8a, 0x00,
+};
+
+/* total 83 bytes, 292 raw */
+
+/* indexed by BitmapId */
+static const uint8_t * const bitmaps[] PROGMEM = {
+    playBitmap,
+    playInvertedBitmap,
+    gameOverBitmap,
+    overOffBitmap,
+    overOnBitmap
+};
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+uint8_t bitmapDraw(uint8_t id, uint16_t *rows, uint8_t count) {
+    const uint8_t *data = pgm_read_ptr(&bitmaps[id]);
+    uint16_t value = 0;
+    uint8_t row = 0;
+
+    while( row < count ) {
+        uint8_t code = pgm_read_byte(data++);
+        uint8_t n = code & BITMAP_RUN_MASK;
+
+        if( code == BITMAP_END ) break;
+        /* never past the destination, whatever the stream says */
+        if( n > count - row ) n = count - row;
+
+        switch( code & BITMAP_OP_MASK ) {
+            case BITMAP_LITERAL:
+                for( ; n>0; n-- ) {
+                    value = (uint16_t)pgm_read_byte(data)<<8 | pgm_read_byte(data + 1);
+                    data += 2;
+                    rows[row++] = value;
+                }
+                break;
+            case BITMAP_REPEAT:
+                for( ; n>0; n-- ) {
+                    rows[row++] = value;
+                }
+                break;
+            case BITMAP_SKIP:
+                row += n;
+                break;
+        }
+    }
+    return row;
+}
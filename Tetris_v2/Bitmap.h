@@ -0,0 +1,54 @@
+/*
+ * @file Bitmap.h
+ * @author: JZimnol
+ * @brief File containing compressed 16 pixel wide bitmaps stored in flash
+ */ 
+
+
+#ifndef BITMAP_H_
+#define BITMAP_H_
+
+#include "Config.h"
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+/*
+ * @brief Stream codes; the low 6 bits are a row count (1..63). The art is
+ *        in Tools/bitmaps.txt and is compressed by Tools/bitmap_encoder.py.
+ */
+#define BITMAP_END          0x00    /* end of the stream */
+#define BITMAP_REPEAT       0x00    /* n rows of the last literal value (0 at first) */
+#define BITMAP_LITERAL      0x40    /* n rows follow, two bytes each, high byte first */
+#define BITMAP_SKIP         0x80    /* n rows are left as they are (delta frames) */
+#define BITMAP_OP_MASK      0xc0
+#define BITMAP_RUN_MASK     0x3f
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Bitmaps in flash. Delta frames only change the rows that differ
+ *        from the bitmap they follow.
+ */
+typedef enum {
+    BITMAP_PLAY          = (uint8_t)0,    /* splash, playfield rows 7..31 */
+    BITMAP_PLAY_INVERTED = (uint8_t)1,    /* splash in negative, playfield rows 7..31 */
+    BITMAP_GAME_OVER     = (uint8_t)2,    /* GAME OVER, whole display */
+    BITMAP_OVER_OFF      = (uint8_t)3,    /* delta of BITMAP_GAME_OVER: OVER cleared */
+    BITMAP_OVER_ON       = (uint8_t)4     /* delta of BITMAP_OVER_OFF: OVER drawn again */
+} BitmapId;
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief decode a bitmap straight into frame buffer rows, nothing is
+ *        buffered in SRAM; a whole display takes well under one tick
+ * @param bitmap id, first destination row and number of rows available
+ * @return rows covered by the bitmap (written or skipped)
+ */
+uint8_t bitmapDraw(uint8_t id, uint16_t *rows, uint8_t count);
+
+#endif /* BITMAP_H_ */
@@ -0,0 +1,86 @@
+/*
+ * @file Blocks.h
+ * @author: JZimnol
+ * @brief File containing the only definition of block shapes. Spawn, preview
+ *        and rotation masks are all generated from it by the preprocessor.
+ */ 
+
+
+#ifndef BLOCKS_H_
+#define BLOCKS_H_
+
+/*************************************************************************\
+                                   MACROS
+\*************************************************************************/
+/*
+ * @brief A shape is a 4x4 box around the core pixel (coords): rows dy = -1..2,
+ *        columns dx = -2..1. Every box row is a nibble whose bit k is column
+ *        dx = k - 2, so a row is placed on the board with << (coords.x - 2).
+ *        Rows dy = 0 and dy = 1 of the spawn shape are also the preview.
+ */
+#define BOX(dyM1, dy0, dy1, dy2)    ((uint16_t)((dyM1) | (dy0)<<4 | (dy1)<<8 | (dy2)<<12))
+#define BOX_ROW(box, dy)            (((box) >> (((dy) + 1)<<2)) & 0x0f)
+
+#define BOX_BIT(dy, dx)             ((((dy) + 1)<<2) + (dx) + 2)
+#define BOX_CELL(box, dy, dx)       (((box) >> BOX_BIT(dy, dx)) & 1)
+/*
+ * @brief Clockwise rotation of the 3x3 square around the core pixel, the same
+ *        permutation the cross/diamond algorithm of Tetris_v1 applies:
+ *        new(dy, dx) = old(dx, -dy)
+ */
+#define ROT3(b) ((uint16_t)( \
+    BOX_CELL(b, -1,  1)<<BOX_BIT(-1, -1) | BOX_CELL(b,  0,  1)<<BOX_BIT(-1, 0) | \
+    BOX_CELL(b,  1,  1)<<BOX_BIT(-1,  1) | BOX_CELL(b, -1,  0)<<BOX_BIT( 0, -1) | \
+    BOX_CELL(b,  0,  0)<<BOX_BIT( 0,  0) | BOX_CELL(b,  1,  0)<<BOX_BIT( 0,  1) | \
+    BOX_CELL(b, -1, -1)<<BOX_BIT( 1, -1) | BOX_CELL(b,  0, -1)<<BOX_BIT( 1, 0) | \
+    BOX_CELL(b,  1, -1)<<BOX_BIT( 1,  1) ))
+
+/*
+ * @brief Four rotation states of a block. 3x3 blocks rotate around the core
+ *        pixel, the I block toggles between its two positions.
+ */
+#define ROTATIONS_3X3(spawn)        { (spawn), ROT3(spawn), ROT3(ROT3(spawn)), ROT3(ROT3(ROT3(spawn))) }
+#define ROTATIONS_TOGGLE(h, v)      { (h), (v), (h), (v) }
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+/*
+ * @brief All blocks, in BlockType order
+ */
+#define SHAPE_I     BOX(0x0, 0xf, 0x0, 0x0)
+#define SHAPE_I_V   BOX(0x4, 0x4, 0x4, 0x4)
+#define SHAPE_J     BOX(0x0, 0xe, 0x2, 0x0)
+#define SHAPE_L     BOX(0x0, 0xe, 0x8, 0x0)
+#define SHAPE_O     BOX(0x0, 0x6, 0x6, 0x0)
+#define SHAPE_S     BOX(0x0, 0x6, 0xc, 0x0)
+#define SHAPE_T     BOX(0x0, 0xe, 0x4, 0x0)
+#define SHAPE_Z     BOX(0x0, 0xc, 0x6, 0x0)
+
+#define BLOCK_ROTATIONS {                           \
+    ROTATIONS_TOGGLE(SHAPE_I, SHAPE_I_V),           \
+    ROTATIONS_3X3(SHAPE_J),                         \
+    ROTATIONS_3X3(SHAPE_L),                         \
+    ROTATIONS_3X3(SHAPE_O),                         \
+    ROTATIONS_3X3(SHAPE_S),                         \
+    ROTATIONS_3X3(SHAPE_T),                         \
+    ROTATIONS_3X3(SHAPE_Z),                         \
+    { 0, 0, 0, 0 }              /* NO_BLOCK */      \
+}
+
+/*
+ * @brief Blocks spawn in rows dy = 0..1 only (row 7 is the top line) and a
+ *        3x3 block has to come back to its spawn shape after four turns
+ */
+#define SHAPE_VALID_3X3(s)  (BOX_ROW(s, -1) == 0 && BOX_ROW(s, 2) == 0 && \
+                             ROT3(ROT3(ROT3(ROT3(s)))) == (s))
+
+_Static_assert(BOX_ROW(SHAPE_I, -1) == 0 && BOX_ROW(SHAPE_I, 2) == 0, "I block spawn shape");
+_Static_assert(SHAPE_VALID_3X3(SHAPE_J), "J block shape");
+_Static_assert(SHAPE_VALID_3X3(SHAPE_L), "L block shape");
+_Static_assert(SHAPE_VALID_3X3(SHAPE_O), "O block shape");
+_Static_assert(SHAPE_VALID_3X3(SHAPE_S), "S block shape");
+_Static_assert(SHAPE_VALID_3X3(SHAPE_T), "T block shape");
+_Static_assert(SHAPE_VALID_3X3(SHAPE_Z), "Z block shape");
+
+#endif /* BLOCKS_H_ */
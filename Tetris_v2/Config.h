@@ -0,0 +1,114 @@
+/*
+ * @file Config.h
+ * @author: JZimnol
+ * @brief File containing build-time options for Tetris game
+ */ 
+
+
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+/*************************************************************************\
+                                  CLOCK
+\*************************************************************************/
+
+#ifndef F_CPU
+    #define F_CPU 8000000UL      /* 8 MHz */
+#endif
+
+/*************************************************************************\
+                                 OPTIONS
+\*************************************************************************/
+/*
+ * @brief Uncomment (or pass with -D) to enable optional subsystems
+ */
+// #define PROFILE_ENABLE        /* Timer1 cycle counters streamed over USART */
+// #define FRAMESTREAM_ENABLE    /* changed display rows streamed over USART */
+// #define SCAN_SKIP_BLANK_ROWS  /* refresh only non-zero rows, constant brightness */
+// #define SAVE_ENABLE           /* resume the game after power off (EEPROM) */
+// #define MEMORY_ENABLE         /* stack high-water mark streamed over USART */
+// #define VERSUS_ENABLE         /* two boards linked by USART send garbage rows */
+// #define LOGIC_TICK_ENABLE     /* game logic at a fixed rate, one composite per tick */
+// #define CLEAR_ANIMATION_ENABLE /* cleared rows flash, wipe and collapse */
+// #define SOUND_ENABLE          /* music and effects on Timer1, speaker on PB1 (OC1A) */
+// #define WATCHDOG_ENABLE       /* refresh overruns and hang resets logged in EEPROM */
+// #define REMOTE_ENABLE         /* actions from a host over USART, for bots and tests */
+// #define REWIND_ENABLE         /* practice mode, left while paused takes back a block */
+
+/*
+ * @brief Pieces shown above the playfield. The 4x7 pixel area next to the
+ *        score has room for two slots (rows 3-4 and rows 0-1); the hold slot
+ *        takes the upper one.
+ */
+#ifndef PREVIEW_COUNT
+    #define PREVIEW_COUNT   1     /* upcoming blocks in the queue */
+#endif
+// #define HOLD_ENABLE           /* left + right together hold the block */
+
+/*
+ * @brief 16-column panels (two 74HC595 column registers each) chained in
+ *        front of the four row registers. Panel 0 is next to the row
+ *        registers and shows frameBuffer.main, panels 1.. show panelMain[].
+ */
+#ifndef DISPLAY_PANELS
+    #define DISPLAY_PANELS  1     /* 1, 2 or 4 were estimated */
+#endif
+/*
+ * @brief Display backend: the 74HC595 chain multiplexed by the refresh ISR
+ *        (default) or eight MAX7219 drivers that scan the matrix themselves
+ */
+// #define DISPLAY_MAX7219       /* no refresh ISR, only changed rows are sent */
+
+/*************************************************************************\
+                               SRAM BUDGET
+\*************************************************************************/
+/*
+ * @brief ATmega328p has 2 KiB of SRAM shared by .data, .bss and the stack.
+ *        The frame buffer is checked at compile time, the whole image by
+ *        Tools/sram_report.py.
+ */
+#define SRAM_SIZE            2048
+#define SRAM_STACK_RESERVE   256     /* bytes kept free for the stack */
+#define FRAMEBUFFER_BUDGET   128     /* bytes for struct FrameBuffer */
+
+/*
+ * @brief USART telemetry is needed by every streaming subsystem; remote
+ *        input uses its packets
+ */
+#if defined(PROFILE_ENABLE) || defined(FRAMESTREAM_ENABLE) || defined(MEMORY_ENABLE) || defined(REMOTE_ENABLE)
+    #define TELEMETRY_ENABLE
+#endif
+
+/*
+ * @brief The versus link needs both USART lines and a lower baud rate
+ */
+#if defined(VERSUS_ENABLE) && defined(TELEMETRY_ENABLE)
+    #error "VERSUS_ENABLE uses the USART, disable the telemetry and remote options"
+#endif
+/*
+ * @brief The MAX7219 chain is one 16x32 panel and has no row slots to skip
+ */
+#if defined(DISPLAY_MAX7219) && (DISPLAY_PANELS != 1 || defined(SCAN_SKIP_BLANK_ROWS))
+    #error "DISPLAY_MAX7219 drives one panel, disable SCAN_SKIP_BLANK_ROWS"
+#endif
+/*
+ * @brief Timer1 is either the profiler's cycle counter or the tone generator
+ */
+#if defined(SOUND_ENABLE) && defined(PROFILE_ENABLE)
+    #error "SOUND_ENABLE uses Timer1, disable PROFILE_ENABLE"
+#endif
+/*
+ * @brief Rewind is a single-player practice mode; garbage already sent to
+ *        the peer cannot be taken back
+ */
+#if defined(REWIND_ENABLE) && defined(VERSUS_ENABLE)
+    #error "REWIND_ENABLE is a practice mode, disable VERSUS_ENABLE"
+#endif
+#if defined(TELEMETRY_ENABLE) || defined(VERSUS_ENABLE)
+    #define USART_ENABLE
+#endif
+#if defined(VERSUS_ENABLE) || defined(REMOTE_ENABLE)
+    #define USART_RX_ENABLE
+#endif
+
+#endif /* CONFIG_H_ */
@@ -0,0 +1,32 @@
+/*
+ * @file Display.h
+ * @author: JZimnol
+ * @brief File containing the selection of the display backend
+ */ 
+
+
+#ifndef DISPLAY_H_
+#define DISPLAY_H_
+
+#include "Config.h"
+
+/*************************************************************************\
+                                 MACROS
+\*************************************************************************/
+/*
+ * @brief DISPLAY_INIT() sets up the backend, DISPLAY_FLUSH() is called
+ *        whenever frameBuffer.main has been written. The 74HC595 chain is
+ *        multiplexed by the refresh ISR (main.c, Scan.c) and reads the frame
+ *        buffer there; MAX7219 drivers scan the matrix themselves and get only
+ *        the changed rows.
+ */
+#ifdef DISPLAY_MAX7219
+    #include "Max7219.h"
+    #define DISPLAY_INIT()      max7219Init()
+    #define DISPLAY_FLUSH()     max7219Flush()
+#else
+    #define DISPLAY_INIT()      SPI_MasterInit()
+    #define DISPLAY_FLUSH()
+#endif
+
+#endif /* DISPLAY_H_ */
@@ -0,0 +1,70 @@
+/*
+ * @file FrameStream.c
+ * @author: JZimnol
+ * @brief File containing definitions for delta encoded display mirroring
+ */ 
+
+#include <avr/io.h>
+#include "Tetris.h"
+#include "FrameStream.h"
+
+#ifdef FRAMESTREAM_ENABLE
+
+#include "Usart.h"
+#include "Telemetry.h"
+#include "Tick.h"
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static uint16_t sentFrame[32];          /* rows as the host has them */
+static uint32_t dirtyRows;              /* rows the host has never received */
+static uint32_t lastSent = 0;           /* tick of the last refresh sent */
+static uint8_t resyncRow = 0;           /* row resent unconditionally */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+void frameStreamInit() {
+    dirtyRows = 0xffffffff;
+    USART_Init();
+}
+
+void frameStreamPoll() {
+    uint8_t packet[FRAMESTREAM_MAX_ROWS * FRAMESTREAM_ROW_SIZE];
+    uint8_t length = 0;
+    uint8_t room;
+    uint32_t now = tickNow();
+
+    /* paced on the timebase, the row number does not wrap when blank rows are skipped */
+    if( now - lastSent < FRAMESTREAM_PERIOD_TICKS ) return;
+    lastSent = now;
+    room = USART_TxFree();
+
+    /* resend one row per refresh, so a viewer started late catches up in 32 frames */
+    dirtyRows |= (uint32_t)1<<resyncRow;
+    resyncRow = (resyncRow + 1) & 31;
+
+    if( room <= TELEMETRY_OVERHEAD ) return;
+    room -= TELEMETRY_OVERHEAD;
+
+    for( uint8_t i=0; i<32; i++ ) {
+        uint16_t row = frameBuffer.main[i];
+
+        if( row == sentFrame[i] && !(dirtyRows & ((uint32_t)1<<i)) ) continue;
+        if( length + FRAMESTREAM_ROW_SIZE > room ) break;
+        packet[length++] = i;
+        packet[length++] = row;
+        packet[length++] = row>>8;
+        /* rows that did not fit stay different and go out on the next refresh */
+        sentFrame[i] = row;
+        dirtyRows &= ~((uint32_t)1<<i);
+        if( length == sizeof(packet) ) break;
+    }
+
+    if( length != 0 ) telemetrySendPacket(PACKET_FRAME_DELTA, packet, length);
+}
+
+#endif /* FRAMESTREAM_ENABLE */
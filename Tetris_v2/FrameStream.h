@@ -0,0 +1,50 @@
+/*
+ * @file FrameStream.h
+ * @author: JZimnol
+ * @brief File containing delta encoded mirroring of the display over USART
+ */ 
+
+
+#ifndef FRAMESTREAM_H_
+#define FRAMESTREAM_H_
+
+#include "Config.h"
+
+#ifdef FRAMESTREAM_ENABLE
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+/*
+ * @brief PACKET_FRAME_DELTA payload is a list of (row, value low, value high)
+ *        triplets; rows that did not change since the last packet are omitted
+ */
+#define FRAMESTREAM_ROW_SIZE    3
+#define FRAMESTREAM_MAX_ROWS    16    /* rows per packet, keeps packets < 64 B */
+#define FRAMESTREAM_PERIOD_TICKS 32   /* one refresh of 32 row slots, 16.4 ms */
+
+#define FRAMESTREAM_INIT()      frameStreamInit()
+#define FRAMESTREAM_POLL()      frameStreamPoll()
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief start the USART and mark the whole display as not yet sent
+ */
+void frameStreamInit();
+/*
+ * @brief send rows of frameBuffer.main that changed since they were last sent;
+ *        at most once per FRAMESTREAM_PERIOD_TICKS, call from the main loop
+ */
+void frameStreamPoll();
+
+#else
+
+#define FRAMESTREAM_INIT()
+#define FRAMESTREAM_POLL()
+
+#endif /* FRAMESTREAM_ENABLE */
+
+#endif /* FRAMESTREAM_H_ */
@@ -0,0 +1,158 @@
+/*
+ * @file Game.c
+ * @author: JZimnol
+ * @brief File containing definitions for the game state machine
+ */ 
+
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#include "Tetris.h"
+#include "Game.h"
+#include "Input.h"
+#include "Logic.h"
+#include "Animation.h"
+#include "Scheduler.h"
+#include "Tick.h"
+#include "Save.h"
+#include "Versus.h"
+#include "Sound.h"
+#include "Rewind.h"
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+
+#define GAME_BEST_ROW       14      /* first row of the best score digits */
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static uint16_t bestScore EEMEM = 0;    /* 0xffff on an erased EEPROM */
+static uint8_t state = GAME_SPLASH;
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+static void gravityStart() {
+#ifdef LOGIC_TICK_ENABLE
+    tickTimerStart(TIMER_GRAVITY, GRAVITY_TICKS(lvl));
+#else
+    tasks[TASK_GRAVITY].period = GRAVITY_TICKS(lvl);
+#endif
+    schedResume(TASK_GRAVITY);
+}
+
+/* hand the board over to the player, a fresh game reuses the initialized hardware */
+static void play(uint8_t fresh) {
+    if( fresh == TRUE ) {
+        VERSUS_RESTART();
+        newGame();
+    }
+    state = GAME_PLAYING;
+    SOUND_MUSIC(fresh == TRUE ? MUSIC_START : MUSIC_RESUME);
+    gravityStart();
+}
+
+static uint8_t playerInput(uint8_t input) {
+#ifdef LOGIC_TICK_ENABLE
+    return logicQueue(input) == TRUE ? EVENT_CONSUMED : EVENT_DROPPED;
+#else
+    return inputApply(input) == TRUE ? EVENT_CONSUMED : EVENT_IGNORED;
+#endif
+}
+
+static void gameOverStart() {
+    state = GAME_OVER;
+    gameOver = TRUE;
+    SAVE_INVALIDATE();
+    VERSUS_GAME_OVER();
+    SOUND_MUSIC(MUSIC_OFF);
+    SOUND_EFFECT(SOUND_GAME_OVER);
+    schedSuspend(TASK_GRAVITY);
+    FRAME_PUBLISH();                /* the block that did not fit */
+    animationStart(ANIM_GAME_OVER, 0);
+}
+
+static void highScoreStart() {
+    uint16_t best = eeprom_read_word(&bestScore);
+
+    state = GAME_HIGH_SCORE;
+    displayScore();
+    /* rare and short (two bytes), so it is written in place; a game with
+       blocks taken back does not count */
+    if( REWIND_USED() == FALSE && (best == 0xffff || pointsCounter > best) ) {
+        best = pointsCounter;
+        eeprom_update_word(&bestScore, best);
+    }
+    displayNumber(GAME_BEST_ROW, best);
+}
+
+void gameInit() {
+    /* a saved game goes straight back into play */
+    if( SAVE_RESTORE() == TRUE ) {
+        play(FALSE);
+        return;
+    }
+    state = GAME_SPLASH;
+    displayPLAY();
+}
+
+uint8_t gameEvent(uint8_t event, uint32_t arg) {
+    /* the origin of a button matters only to the remote counters */
+    uint8_t input = (uint8_t)arg & ~INPUT_REMOTE;
+
+    switch( state ) {
+        case GAME_SPLASH:
+            if( event == EVENT_BUTTON && input == INPUT_ROTATE && animationBusy() == FALSE ) {
+                animationStart(ANIM_START, 0);
+            }
+            else if( event == EVENT_ANIMATION_DONE ) play(TRUE);
+            else return EVENT_IGNORED;
+            break;
+        case GAME_PLAYING:
+            if( event == EVENT_BUTTON ) {
+                if( input != INPUT_PAUSE ) return playerInput(arg);
+                state = GAME_PAUSED;
+                SOUND_MUSIC(MUSIC_OFF);
+                schedSuspend(TASK_GRAVITY);
+            }
+            else if( event == EVENT_LINES_CLEARED ) {
+                state = GAME_CLEARING;
+                schedSuspend(TASK_GRAVITY);
+                animationStart(ANIM_LINE_CLEAR, arg);
+            }
+            else if( event == EVENT_TOP_OUT ) gameOverStart();
+            else return EVENT_IGNORED;
+            break;
+        case GAME_PAUSED:
+            if( event == EVENT_BUTTON && input == INPUT_PAUSE ) play(FALSE);
+            else if( event == EVENT_TOP_OUT ) gameOverStart();
+            /* practice mode: left takes back the last block */
+            else if( event != EVENT_BUTTON || input != INPUT_LEFT || REWIND_UNDO() == FALSE ) return EVENT_IGNORED;
+            break;
+        case GAME_CLEARING:
+            if( event == EVENT_ANIMATION_DONE ) play(FALSE);
+            else if( event == EVENT_TOP_OUT ) gameOverStart();
+            else return EVENT_IGNORED;
+            break;
+        case GAME_OVER:
+            if( event == EVENT_ANIMATION_DONE ) highScoreStart();
+            else return EVENT_IGNORED;
+            break;
+        case GAME_HIGH_SCORE:
+            if( event == EVENT_BUTTON && input == INPUT_ROTATE ) play(TRUE);
+            else return EVENT_IGNORED;
+            break;
+    }
+    return EVENT_CONSUMED;
+}
+
+uint8_t gameState() {
+    return state;
+}
+
+void GameOver() {
+    gameEvent(EVENT_TOP_OUT, 0);
+}
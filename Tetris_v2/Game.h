@@ -0,0 +1,75 @@
+/*
+ * @file Game.h
+ * @author: JZimnol
+ * @brief File containing the game state machine
+ */ 
+
+
+#ifndef GAME_H_
+#define GAME_H_
+
+#include "Config.h"
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief States of the game
+ */
+typedef enum {
+    GAME_SPLASH     = (uint8_t)0,    /* PLAY screen, waiting for rotate */
+    GAME_PLAYING    = (uint8_t)1,
+    GAME_PAUSED     = (uint8_t)2,    /* board frozen until the pause buttons again; left takes back a block (REWIND_ENABLE) */
+    GAME_CLEARING   = (uint8_t)3,    /* line clear animation, board frozen */
+    GAME_OVER       = (uint8_t)4,    /* game over animation */
+    GAME_HIGH_SCORE = (uint8_t)5     /* score and best score, rotate plays again */
+} GameState;
+/*
+ * @brief Events driving the state machine
+ */
+typedef enum {
+    EVENT_BUTTON         = (uint8_t)0,    /* argument: Input action */
+    EVENT_LINES_CLEARED  = (uint8_t)1,    /* argument: cleared rows, bit n = row n */
+    EVENT_ANIMATION_DONE = (uint8_t)2,
+    EVENT_TOP_OUT        = (uint8_t)3     /* no room for the block or the peer lost */
+} GameEvent;
+/*
+ * @brief What the state machine did with an event
+ */
+typedef enum {
+    EVENT_DROPPED        = (uint8_t)0,    /* full input queue, send it again later */
+    EVENT_CONSUMED       = (uint8_t)1,
+    EVENT_IGNORED        = (uint8_t)2     /* means nothing in this state */
+} EventResult;
+
+/*************************************************************************\
+                                 MACROS
+\*************************************************************************/
+
+#ifdef CLEAR_ANIMATION_ENABLE
+    #define GAME_LINES_CLEARED(rows)    do { if( rows ) gameEvent(EVENT_LINES_CLEARED, (rows)); } while(0)
+#else
+    #define GAME_LINES_CLEARED(rows)
+#endif
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief continue a saved game or show the splash screen
+ */
+void gameInit();
+/*
+ * @brief feed one event to the state machine
+ * @param event and its argument; a button may carry INPUT_REMOTE
+ * @return EventResult
+ */
+uint8_t gameEvent(uint8_t event, uint32_t arg);
+/*
+ * @brief get the current state
+ * @return GameState
+ */
+uint8_t gameState();
+
+#endif /* GAME_H_ */
@@ -0,0 +1,78 @@
+/*
+ * @file Input.c
+ * @author: JZimnol
+ * @brief File containing definitions for button sampling and player actions
+ */ 
+
+#include <avr/io.h>
+#include "Tetris.h"
+#include "Input.h"
+#include "Tick.h"
+#include "Game.h"
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static uint8_t pauseHeld = FALSE;       /* pause combo still pushed, do not toggle again */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+uint8_t inputRead() {
+    uint8_t input = INPUT_NONE;
+
+    if( !tickTimerIdle(TIMER_DEBOUNCE) ) return INPUT_NONE;
+
+    if( PC1_PUSHED && PC3_PUSHED ) {
+        if( pauseHeld == FALSE ) input = INPUT_PAUSE;
+        pauseHeld = TRUE;
+    }
+    else {
+        pauseHeld = FALSE;
+        /* same priority as the original if-chain: the first pushed button wins */
+#ifdef HOLD_ENABLE
+        /* no button of its own, so hold is left and right pushed together */
+        if( PC0_PUSHED && PC2_PUSHED ) input = INPUT_HOLD;
+        else
+#endif
+        if( PC2_PUSHED ) input = INPUT_LEFT;
+        else if( PC3_PUSHED ) input = INPUT_DOWN;
+        else if( PC0_PUSHED ) input = INPUT_RIGHT;
+        else if( PC1_PUSHED ) input = INPUT_ROTATE;
+    }
+
+    if( input != INPUT_NONE ) tickTimerStart(TIMER_DEBOUNCE, DEBOUNCE_TICKS);
+    return input;
+}
+
+uint8_t inputApply(uint8_t input) {
+    /* actions queued behind one that cleared rows or ended the game are dropped */
+    if( gameState() != GAME_PLAYING ) return FALSE;
+    switch( input & ~INPUT_REMOTE ) {
+        case INPUT_LEFT:
+            moveBlockLeft();
+            break;
+        case INPUT_RIGHT:
+            moveBlockRight();
+            break;
+        case INPUT_DOWN:
+            moveBlockDown();
+            break;
+        case INPUT_ROTATE:
+            rotateBlockRight();
+            break;
+        case INPUT_HOLD:
+            holdBlock();
+            break;
+        case INPUT_DROP:
+            while( is_spaceDown() == TRUE ) moveBlockDown();
+            /* the line clear animation replays over the last frame, so it has
+               to show the block where it lands before the last step locks it */
+            FRAME_PUBLISH();
+            moveBlockDown();
+            break;
+    }
+    return TRUE;
+}
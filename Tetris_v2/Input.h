@@ -0,0 +1,48 @@
+/*
+ * @file Input.h
+ * @author: JZimnol
+ * @brief File containing button sampling and player actions
+ */ 
+
+
+#ifndef INPUT_H_
+#define INPUT_H_
+
+#include "Config.h"
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Player actions produced by the buttons
+ */
+typedef enum {
+    INPUT_NONE   = (uint8_t)0,
+    INPUT_LEFT   = (uint8_t)1,
+    INPUT_RIGHT  = (uint8_t)2,
+    INPUT_DOWN   = (uint8_t)3,
+    INPUT_ROTATE = (uint8_t)4,
+    INPUT_HOLD   = (uint8_t)5,
+    INPUT_PAUSE  = (uint8_t)6,    /* rotate and down together, once per push */
+    INPUT_DROP   = (uint8_t)7     /* hard drop, remote input only */
+} Input;
+
+#define INPUT_REMOTE    0x80      /* flag on actions from the remote link */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief sample the buttons; a held button repeats every DEBOUNCE_TICKS
+ * @return at most one action per call, INPUT_NONE if there is nothing to do
+ */
+uint8_t inputRead();
+/*
+ * @brief apply one action to the falling block
+ * @param action, INPUT_REMOTE is ignored
+ * @return false if the game is not played and the action was discarded
+ */
+uint8_t inputApply(uint8_t input);
+
+#endif /* INPUT_H_ */
@@ -0,0 +1,57 @@
+/*
+ * @file Logic.c
+ * @author: JZimnol
+ * @brief File containing definitions for the fixed-rate game logic tick
+ */ 
+
+#include <avr/io.h>
+#include "Tetris.h"
+#include "Logic.h"
+
+#ifdef LOGIC_TICK_ENABLE
+
+#include "Input.h"
+#include "Game.h"
+#include "Remote.h"
+#include "Profiler.h"
+#include "Tick.h"
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static uint8_t inputQueue[LOGIC_INPUT_QUEUE];   /* oldest action first */
+static uint8_t inputQueued = 0;
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+uint8_t logicQueue(uint8_t input) {
+    if( inputQueued == LOGIC_INPUT_QUEUE ) return FALSE;
+    inputQueue[inputQueued++] = input;
+    return TRUE;
+}
+
+void logicTick() {
+    PROFILE_BEGIN(PROF_LOGIC_TICK);
+    for( uint8_t i=0; i<inputQueued; i++ ) {
+        uint8_t input = inputQueue[i];
+        if( inputApply(input) == TRUE ) continue;
+        /* a remote action counted as applied when it was queued was not */
+        REMOTE_IGNORED(input);
+    }
+    inputQueued = 0;
+
+    /* gravity and locking run at the logic rate too */
+    if( gameState() == GAME_PLAYING && tickTimerExpired(TIMER_GRAVITY) ) {
+        moveBlockDown();
+        tickTimerStart(TIMER_GRAVITY, GRAVITY_TICKS(lvl));
+    }
+
+    /* the ISR sees only whole ticks, never a half-applied action */
+    FRAME_PUBLISH();
+    PROFILE_END(PROF_LOGIC_TICK);
+}
+
+#endif /* LOGIC_TICK_ENABLE */
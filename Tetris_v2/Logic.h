@@ -0,0 +1,41 @@
+/*
+ * @file Logic.h
+ * @author: JZimnol
+ * @brief File containing optional fixed-rate game logic tick
+ */ 
+
+
+#ifndef LOGIC_H_
+#define LOGIC_H_
+
+#include "Config.h"
+
+#ifdef LOGIC_TICK_ENABLE
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+
+#define LOGIC_TICK_PERIOD       32    /* ticks per logic tick (16.384 ms, ~61 Hz) */
+#define LOGIC_TICK_DEADLINE     4     /* ticks from the due time to the end of the tick */
+#define LOGIC_INPUT_QUEUE       4     /* actions waiting for the next logic tick */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief keep an action for the next logic tick
+ * @param action
+ * @return true if queued, false if the queue is full
+ */
+uint8_t logicQueue(uint8_t input);
+/*
+ * @brief apply the queued actions and gravity, then publish one composite;
+ *        the gravity task runs it every LOGIC_TICK_PERIOD
+ */
+void logicTick();
+
+#endif /* LOGIC_TICK_ENABLE */
+
+#endif /* LOGIC_H_ */
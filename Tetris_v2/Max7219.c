@@ -0,0 +1,76 @@
+/*
+ * @file Max7219.c
+ * @author: JZimnol
+ * @brief File containing definitions for the MAX7219 display backend
+ */ 
+
+#include <avr/io.h>
+#include "Tetris.h"
+#include "Max7219.h"
+
+#ifdef DISPLAY_MAX7219
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static uint16_t shownRows[32];          /* rows as the drivers have them */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/* the same register and value for every chip */
+static void writeAll(uint8_t reg, uint8_t value) {
+    LT_OFF;
+    for( uint8_t chip=0; chip<MAX7219_CHIPS; chip++ ) {
+        SPI_MasterTransmit_16bit((uint16_t)reg<<8 | value);
+    }
+    LT_ON;                              /* rising LOAD edge latches every chip */
+}
+
+void max7219Init() {
+    /* Set MOSI, LOAD and SCK output, all others input */
+    DDRB = (1<<PB3) | (1<<PB5) | (1<<PB2);
+    LT_ON;
+    /* Enable SPI, Master, set clock rate fck/2, MSB first */
+    SPCR = (1<<SPE) | (1<<MSTR);
+    SPSR = (1<<SPI2X);
+
+    writeAll(MAX7219_TEST, 0);
+    writeAll(MAX7219_DECODE, 0);        /* raw segments */
+    writeAll(MAX7219_SCAN_LIMIT, 7);
+    writeAll(MAX7219_INTENSITY, MAX7219_BRIGHTNESS);
+    for( uint8_t digit=0; digit<8; digit++ ) {
+        writeAll(MAX7219_DIGIT0 + digit, 0);
+    }
+    for( uint8_t i=0; i<32; i++ ) {
+        shownRows[i] = 0;
+    }
+    writeAll(MAX7219_SHUTDOWN, 1);
+}
+
+void max7219Flush() {
+    for( uint8_t digit=0; digit<8; digit++ ) {
+        uint8_t changed = FALSE;
+
+        for( uint8_t row=digit; row<32; row += 8 ) {
+            if( frameBuffer.main[row] != shownRows[row] ) changed = TRUE;
+        }
+        if( changed == FALSE ) continue;
+
+        LT_OFF;
+        /* the farthest chip has to be shifted in first */
+        for( uint8_t chip=MAX7219_CHIPS; chip>0; chip-- ) {
+            uint8_t row = ((chip - 1)>>1)*8 + digit;
+            uint16_t value = frameBuffer.main[row];
+            shownRows[row] = value;
+            if( (chip - 1) & 1 ) value &= 0xff;
+            else value >>= 8;
+            SPI_MasterTransmit_16bit((uint16_t)(MAX7219_DIGIT0 + digit)<<8 | value);
+        }
+        LT_ON;
+    }
+}
+
+#endif /* DISPLAY_MAX7219 */
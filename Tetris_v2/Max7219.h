@@ -0,0 +1,53 @@
+/*
+ * @file Max7219.h
+ * @author: JZimnol
+ * @brief File containing the MAX7219 display backend
+ */ 
+
+
+#ifndef MAX7219_H_
+#define MAX7219_H_
+
+#include "Config.h"
+
+#ifdef DISPLAY_MAX7219
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+/*
+ * @brief Eight 8x8 drivers in one daisy chain (DIN on MOSI, CLK on SCK, LOAD
+ *        on PB2). Chip 0 is next to the MCU. Chip 2*b drives columns 15..8
+ *        and chip 2*b+1 columns 7..0 of rows 8*b..8*b+7; digit register d
+ *        holds row 8*b+d, bit 7 is the leftmost column.
+ */
+#define MAX7219_CHIPS       8
+#define MAX7219_DIGIT0      0x01    /* register of digit 0, digits are 0x01..0x08 */
+#define MAX7219_DECODE      0x09
+#define MAX7219_INTENSITY   0x0a
+#define MAX7219_SCAN_LIMIT  0x0b
+#define MAX7219_SHUTDOWN    0x0c
+#define MAX7219_TEST        0x0f
+
+#ifndef MAX7219_BRIGHTNESS
+    #define MAX7219_BRIGHTNESS  4   /* 0..15, duty cycle (2n+1)/32 */
+#endif
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief set up SPI (MSB first, fck/2) and the drivers, clear the display
+ */
+void max7219Init();
+/*
+ * @brief send the rows of frameBuffer.main that differ from the displayed
+ *        ones; one transfer writes the same digit of all chips, so a
+ *        changed row costs MAX7219_CHIPS words and unchanged digits none
+ */
+void max7219Flush();
+
+#endif /* DISPLAY_MAX7219 */
+
+#endif /* MAX7219_H_ */
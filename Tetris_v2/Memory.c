@@ -0,0 +1,91 @@
+/*
+ * @file Memory.c
+ * @author: JZimnol
+ * @brief File containing definitions for stack high-water mark measurement
+ */ 
+
+#include <avr/io.h>
+#include "Tetris.h"
+#include "Memory.h"
+
+#ifdef MEMORY_ENABLE
+
+#include "Usart.h"
+#include "Telemetry.h"
+#include "Tick.h"
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+extern uint8_t _end;            /* first byte after .bss/.noinit (linker) */
+extern uint8_t __stack;         /* initial stack pointer, RAMEND (linker) */
+
+static uint8_t sendPending = FALSE;     /* period elapsed, packet not queued yet */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * Runs from .init1, before the stack pointer and r1 are set up, so it is
+ * written in assembly: fill everything from the end of .bss up to RAMEND
+ * with the canary.
+ */
+void memoryPaint() __attribute__((naked, used, section(".init1")));
+void memoryPaint() {
+    __asm volatile (
+        "    ldi r30, lo8(_end)       \n"
+        "    ldi r31, hi8(_end)       \n"
+        "    ldi r24, %0              \n"
+        "    ldi r25, hi8(__stack)    \n"
+        "    rjmp 2f                  \n"
+        "1:  st Z+, r24               \n"
+        "2:  cpi r30, lo8(__stack)    \n"
+        "    cpc r31, r25             \n"
+        "    brlo 1b                  \n"
+        "    breq 1b                  \n"
+        :
+        : "i" (MEMORY_CANARY)
+    );
+}
+
+void memoryInit() {
+    tickTimerStartPeriodic(TIMER_MEMORY, MEMORY_STREAM_PERIOD);
+    USART_Init();
+}
+
+uint16_t memoryStackFree() {
+    const uint8_t *p = &_end;
+    /* the stack grows down, so the first painted byte it overwrote marks the peak */
+    while( p <= &__stack && *p == MEMORY_CANARY ) {
+        p++;
+    }
+    return p - &_end;
+}
+
+void memoryGetStats(MemoryStats *stats) {
+    uint16_t region = &__stack - &_end + 1;     /* bytes shared by stack and heap */
+
+    stats->staticBytes = &_end - (uint8_t *)RAMSTART;
+    stats->stackFree = memoryStackFree();
+    stats->stackPeak = region - stats->stackFree;
+    stats->stackNow = (uint16_t)&__stack - SP;
+}
+
+void memoryPoll() {
+    MemoryStats stats;
+
+    if( sendPending == FALSE ) {
+        if( tickTimerExpired(TIMER_MEMORY) == FALSE ) return;
+        sendPending = TRUE;
+    }
+
+    memoryGetStats(&stats);
+    /* on a full buffer retry on the next poll */
+    if( telemetrySendPacket(PACKET_MEMORY, &stats, sizeof(stats)) == TRUE ) {
+        sendPending = FALSE;
+    }
+}
+
+#endif /* MEMORY_ENABLE */
@@ -0,0 +1,72 @@
+/*
+ * @file Memory.h
+ * @author: JZimnol
+ * @brief File containing optional stack high-water mark measurement
+ */ 
+
+
+#ifndef MEMORY_H_
+#define MEMORY_H_
+
+#include "Config.h"
+
+#ifdef MEMORY_ENABLE
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+
+#define MEMORY_CANARY           0xc5  /* paint pattern of the unused stack */
+#define MEMORY_STREAM_PERIOD    1024  /* ticks (~0.5 s) between packets */
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief SRAM usage in bytes; sent as is in PACKET_MEMORY payload
+ */
+typedef struct {
+    uint16_t staticBytes;   /* .data + .bss (+ .noinit) */
+    uint16_t stackPeak;     /* deepest stack reached since reset, ISRs included */
+    uint16_t stackFree;     /* never touched bytes between .bss and the stack */
+    uint16_t stackNow;      /* stack in use at the moment of the report */
+} MemoryStats;
+
+/*************************************************************************\
+                                 MACROS
+\*************************************************************************/
+
+#define MEMORY_INIT()           memoryInit()
+#define MEMORY_POLL()           memoryPoll()
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief start the report period; the stack itself is painted before main()
+ */
+void memoryInit();
+/*
+ * @brief count untouched canary bytes above the end of .bss
+ * @return bytes the stack has never reached
+ */
+uint16_t memoryStackFree();
+/*
+ * @brief fill current SRAM statistics
+ * @param destination
+ */
+void memoryGetStats(MemoryStats *stats);
+/*
+ * @brief send statistics when the report period elapsed; call from the main loop
+ */
+void memoryPoll();
+
+#else
+
+#define MEMORY_INIT()
+#define MEMORY_POLL()
+
+#endif /* MEMORY_ENABLE */
+
+#endif /* MEMORY_H_ */
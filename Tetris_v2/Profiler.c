@@ -0,0 +1,87 @@
+/*
+ * @file Profiler.c
+ * @author: JZimnol
+ * @brief File containing definitions for cycle instrumentation
+ */ 
+
+#include <avr/io.h>
+#include <util/atomic.h>
+#include "Tetris.h"
+#include "Profiler.h"
+
+#ifdef PROFILE_ENABLE
+
+#include "Usart.h"
+#include "Telemetry.h"
+#include "Tick.h"
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static ProfileStats profileStats[PROF_COUNT];
+static uint8_t profileNextId = 0;       /* entry sent in next packet */
+static uint8_t sendPending = FALSE;     /* period elapsed, packet not queued yet */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+void profilerInit() {
+    TCCR1A = 0;
+    TCCR1B = (1<<CS10);               /* normal mode, no prescaling */
+    for( uint8_t i=0; i<PROF_COUNT; i++ ) {
+        profileStats[i].calls = 0;
+        profileStats[i].min = 0xffff;
+        profileStats[i].max = 0;
+        profileStats[i].total = 0;
+        for( uint8_t j=0; j<PROFILE_BUCKETS; j++ ) {
+            profileStats[i].histogram[j] = 0;
+        }
+    }
+    tickTimerStartPeriodic(TIMER_PROFILE, PROFILE_STREAM_PERIOD);
+    USART_Init();
+}
+
+void profilerRecord(uint8_t id, uint16_t cycles) {
+    ProfileStats *stats = &profileStats[id];
+    uint8_t bucket = 0;
+
+    /* bucket = floor(log2(cycles)) - 7, clamped to the histogram size */
+    for( uint16_t c = cycles>>8; c != 0 && bucket < PROFILE_BUCKETS - 1; c >>= 1 ) {
+        bucket++;
+    }
+
+    stats->calls++;
+    stats->total += cycles;
+    if( cycles < stats->min ) stats->min = cycles;
+    if( cycles > stats->max ) stats->max = cycles;
+    stats->histogram[bucket]++;
+}
+
+void profilerPoll() {
+    uint8_t packet[1 + sizeof(ProfileStats)];
+
+    if( sendPending == FALSE ) {
+        if( tickTimerExpired(TIMER_PROFILE) == FALSE ) return;
+        sendPending = TRUE;
+    }
+
+    packet[0] = profileNextId;
+    /* the refresh ISR updates its own entry, so take a consistent copy */
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        const uint8_t *src = (const uint8_t *)&profileStats[profileNextId];
+        for( uint8_t i=0; i<sizeof(ProfileStats); i++ ) {
+            packet[i + 1] = src[i];
+        }
+    }
+
+    /* on a full buffer keep the same entry and retry on the next poll */
+    if( telemetrySendPacket(PACKET_PROFILE, packet, sizeof(packet)) == TRUE ) {
+        sendPending = FALSE;
+        profileNextId++;
+        if( profileNextId == PROF_COUNT ) profileNextId = 0;
+    }
+}
+
+#endif /* PROFILE_ENABLE */
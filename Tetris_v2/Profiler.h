@@ -0,0 +1,91 @@
+/*
+ * @file Profiler.h
+ * @author: JZimnol
+ * @brief File containing optional cycle instrumentation of hot game functions
+ */ 
+
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include "Config.h"
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Instrumented code regions
+ */
+typedef enum {
+    PROF_REFRESH_ISR      = (uint8_t)0,
+    PROF_MOVE_BLOCK_DOWN  = (uint8_t)1,
+    PROF_DELETE_LEVEL     = (uint8_t)2,
+    PROF_ROTATE_BLOCK     = (uint8_t)3,
+    PROF_UPDATE_FB        = (uint8_t)4,
+    PROF_UPDATE_POINTS    = (uint8_t)5,
+    PROF_LOGIC_TICK       = (uint8_t)6,
+    PROF_COUNT            = (uint8_t)7
+} ProfileId;
+
+#ifdef PROFILE_ENABLE
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+
+#define PROFILE_BUCKETS         8     /* log2 histogram, bucket 0 is < 256 cycles */
+#define PROFILE_STREAM_PERIOD   128   /* ticks (~65 ms) between packets */
+
+/*
+ * @brief Statistics of one region; sent as is in PACKET_PROFILE payload
+ */
+typedef struct {
+    uint16_t calls;
+    uint16_t min;
+    uint16_t max;
+    uint32_t total;
+    uint16_t histogram[PROFILE_BUCKETS];
+} ProfileStats;
+
+/*************************************************************************\
+                                 MACROS
+\*************************************************************************/
+/*
+ * @brief Timer1 runs at F_CPU, so one count is one cycle. Regions longer than
+ *        65535 cycles (8.2 ms) wrap. Time spent in the refresh ISR is included
+ *        in every region it preempts.
+ */
+#define PROFILE_INIT()          profilerInit()
+#define PROFILE_POLL()          profilerPoll()
+#define PROFILE_BEGIN(id)       uint16_t profileStart_##id = TCNT1
+#define PROFILE_END(id)         profilerRecord((id), TCNT1 - profileStart_##id)
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief start Timer1 free running at F_CPU and clear statistics
+ */
+void profilerInit();
+/*
+ * @brief accumulate one measurement
+ * @param region id and measured cycles
+ */
+void profilerRecord(uint8_t id, uint16_t cycles);
+/*
+ * @brief send next statistics packet when the stream period elapsed;
+ *        call from the main loop
+ */
+void profilerPoll();
+
+#else
+
+#define PROFILE_INIT()
+#define PROFILE_POLL()
+#define PROFILE_BEGIN(id)
+#define PROFILE_END(id)
+
+#endif /* PROFILE_ENABLE */
+
+#endif /* PROFILER_H_ */
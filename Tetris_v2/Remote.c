@@ -0,0 +1,143 @@
+/*
+ * @file Remote.c
+ * @author: JZimnol
+ * @brief File containing definitions for remote input over the USART
+ */ 
+
+#include <avr/io.h>
+#include <util/crc16.h>
+#include "Tetris.h"
+#include "Remote.h"
+#include "Usart.h"
+#include "Telemetry.h"
+#include "Input.h"
+#include "Game.h"
+#include "Tick.h"
+
+#ifdef REMOTE_ENABLE
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Action waiting for its time
+ */
+typedef struct {
+    uint8_t action;
+    uint16_t at;
+} RemoteAction;
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static RemoteAction queue[REMOTE_QUEUE_SIZE];
+static uint8_t queueHead = 0;           /* oldest action */
+static uint8_t queueTail = 0;
+static RemoteStats stats;
+static uint8_t packet[REMOTE_PAYLOAD_MAX + 3];  /* type, length, payload, crc */
+static uint8_t packetIndex = 0;         /* 0 = waiting for sync */
+static uint8_t nextSeq;
+static uint8_t seqKnown = FALSE;        /* the first packet sets the sequence */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+static void receiveInput(const uint8_t *payload) {
+    uint8_t seq = payload[0];
+    uint8_t tail = (queueTail + 1) & (REMOTE_QUEUE_SIZE - 1);
+
+    if( seqKnown == TRUE ) stats.lost += (uint8_t)(seq - nextSeq);
+    nextSeq = seq + 1;
+    seqKnown = TRUE;
+    if( payload[1] == INPUT_NONE || payload[1] > INPUT_DROP ) {
+        stats.rejected++;
+        return;
+    }
+    stats.received++;
+
+    if( tail == queueHead ) {
+        stats.overflows++;
+        return;
+    }
+    queue[queueTail].action = payload[1];
+    queue[queueTail].at = payload[2] | (payload[3]<<8);
+    queueTail = tail;
+}
+
+static void receivePacket() {
+    uint8_t type = packet[0], length = packet[1];
+
+    if( type == PACKET_REMOTE_INPUT && length == REMOTE_INPUT_BYTES ) {
+        receiveInput(&packet[2]);
+    }
+    else if( type == PACKET_REMOTE_STATUS && length == 0 ) {
+        stats.now = (uint16_t)tickNow();
+        stats.queued = (queueTail - queueHead) & (REMOTE_QUEUE_SIZE - 1);
+        telemetrySendPacket(PACKET_REMOTE_STATUS, &stats, sizeof(RemoteStats));
+        /* a new host run starts its sequence again */
+        seqKnown = FALSE;
+    }
+    else stats.rejected++;
+}
+
+/* SYNC | type | length | payload | crc, one byte at a time */
+static void receiveByte(uint8_t data) {
+    if( packetIndex == 0 ) {
+        if( data == TELEMETRY_SYNC ) packetIndex = 1;
+        return;
+    }
+    packet[packetIndex - 1] = data;
+    if( packetIndex == 2 && data > REMOTE_PAYLOAD_MAX ) {
+        stats.rejected++;
+        packetIndex = 0;
+        return;
+    }
+    packetIndex++;
+    if( packetIndex > 2 && packetIndex == packet[1] + 4 ) {
+        uint8_t crc = 0;
+        for( uint8_t i=0; i<packet[1] + 2; i++ ) {
+            crc = _crc8_ccitt_update(crc, packet[i]);
+        }
+        if( crc == packet[packet[1] + 2] ) receivePacket();
+        else stats.rejected++;
+        packetIndex = 0;
+    }
+}
+
+void remoteInit() {
+    USART_Init();
+}
+
+void remotePoll() {
+    uint8_t data;
+    RemoteAction *next;
+    int16_t behind;
+    uint8_t result;
+
+    while( USART_Receive(&data) ) {
+        receiveByte(data);
+    }
+    if( queueHead == queueTail ) return;
+
+    /* one action per call, like a button */
+    next = &queue[queueHead];
+    behind = (int16_t)((uint16_t)tickNow() - next->at);
+    if( behind < 0 ) return;
+    result = gameEvent(EVENT_BUTTON, next->action | INPUT_REMOTE);
+    /* a full logic queue keeps the action for the next call */
+    if( result == EVENT_DROPPED ) return;
+    if( behind > 0 ) stats.late++;
+    if( result == EVENT_CONSUMED ) stats.applied++;
+    else stats.ignored++;
+    queueHead = (queueHead + 1) & (REMOTE_QUEUE_SIZE - 1);
+}
+
+void remoteIgnored(uint8_t input) {
+    if( !(input & INPUT_REMOTE) ) return;
+    stats.applied--;
+    stats.ignored++;
+}
+
+#endif /* REMOTE_ENABLE */
@@ -0,0 +1,88 @@
+/*
+ * @file Remote.h
+ * @author: JZimnol
+ * @brief File containing optional remote input over the USART, for bots and
+ *        automated tests
+ */ 
+
+
+#ifndef REMOTE_H_
+#define REMOTE_H_
+
+#include "Config.h"
+
+#ifdef REMOTE_ENABLE
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+/*
+ * @brief Packets in both directions use the telemetry framing (Telemetry.h).
+ *        PACKET_REMOTE_INPUT payload: seq | action | at (little endian).
+ *        The action (Input) is applied when the low 16 bits of tickNow()
+ *        reach `at`; a time in the past is applied at once and counted as
+ *        late. PACKET_REMOTE_STATUS with no payload asks for the counters,
+ *        the board answers with a PACKET_REMOTE_STATUS carrying RemoteStats;
+ *        the next input packet may start a new sequence.
+ *        Stamp actions less than REMOTE_QUEUE_SIZE packets ahead, or the
+ *        queue overflows.
+ */
+#define REMOTE_QUEUE_SIZE       8     /* actions waiting for their time, power of two */
+#define REMOTE_INPUT_BYTES      4
+#define REMOTE_PAYLOAD_MAX      4     /* longer packets are rejected */
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Counters sent in a status packet; they wrap at 65536
+ */
+typedef struct {
+    uint16_t now;                   /* low 16 bits of tickNow() */
+    uint16_t received;              /* valid input packets */
+    uint16_t applied;               /* actions the state machine consumed */
+    uint16_t ignored;               /* actions that meant nothing in the game state */
+    uint16_t late;                  /* applied after their time */
+    uint16_t overflows;             /* dropped, the queue was full */
+    uint16_t rejected;              /* bad CRC, length or action */
+    uint16_t lost;                  /* gaps in the sequence numbers */
+    uint8_t queued;                 /* actions waiting */
+} RemoteStats;
+
+/*************************************************************************\
+                                 MACROS
+\*************************************************************************/
+
+#define REMOTE_INIT()           remoteInit()
+#define REMOTE_POLL()           remotePoll()
+#define REMOTE_IGNORED(input)   remoteIgnored(input)
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief start the USART (transmitter and receiver)
+ */
+void remoteInit();
+/*
+ * @brief parse received packets and give the next due action to the game
+ *        state machine, the same way as a button; call from the input task
+ */
+void remotePoll();
+/*
+ * @brief count an applied action as ignored after all; the logic tick calls
+ *        it for a queued action that arrived after the game state changed
+ * @param action as queued, only actions with INPUT_REMOTE are counted
+ */
+void remoteIgnored(uint8_t input);
+
+#else
+
+#define REMOTE_INIT()
+#define REMOTE_POLL()
+#define REMOTE_IGNORED(input)
+
+#endif /* REMOTE_ENABLE */
+
+#endif /* REMOTE_H_ */
@@ -0,0 +1,214 @@
+/*
+ * @file Rewind.c
+ * @author: JZimnol
+ * @brief File containing definitions for the practice mode snapshots
+ */ 
+
+#include <avr/io.h>
+#include "Tetris.h"
+#include "Rewind.h"
+
+#ifdef REWIND_ENABLE
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+/*
+ * Entry in the ring, oldest byte first:
+ *   rows | first row | row[rows] | blocks | queue[PREVIEW_COUNT] |
+ *   points | lvl | random | rows
+ * The rows byte is at both ends, so entries can be walked from either end.
+ */
+#define ROWS_WIDE           0x80    /* two bytes per row */
+#define ROWS_COUNT          0x1f
+#define ENTRY_FIXED         (10 + PREVIEW_COUNT)     /* bytes besides the rows */
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Everything of a snapshot except the floor
+ */
+typedef struct {
+    uint8_t blocks;                 /* current | held<<3 */
+    uint8_t queue[PREVIEW_COUNT];
+    uint16_t points;
+    uint16_t lvl;
+    uint16_t random;
+} RewindState;
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static uint8_t ring[REWIND_BUFFER_SIZE];
+static uint16_t ringHead = 0;           /* next byte to write */
+static uint16_t ringUsed = 0;
+static uint16_t lastFloor[REWIND_ROWS]; /* floor of the newest snapshot */
+static RewindState lastState;
+static uint8_t lastValid = FALSE;
+static uint8_t used = FALSE;
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+static uint16_t ringIndex(uint16_t index) {
+    return index >= REWIND_BUFFER_SIZE ? index - REWIND_BUFFER_SIZE : index;
+}
+
+static void put(uint8_t data) {
+    ring[ringHead] = data;
+    ringHead = ringIndex(ringHead + 1);
+    ringUsed++;
+}
+
+static void put16(uint16_t data) {
+    put(data & 0xff);
+    put(data >> 8);
+}
+
+static uint8_t get(uint16_t *index) {
+    uint8_t data = ring[*index];
+    *index = ringIndex(*index + 1);
+    return data;
+}
+
+static uint16_t get16(uint16_t *index) {
+    uint8_t low = get(index);
+    return low | (get(index) << 8);
+}
+
+static uint8_t entrySize(uint8_t rows) {
+    return ENTRY_FIXED + (rows & ROWS_COUNT) * (rows & ROWS_WIDE ? 2 : 1);
+}
+
+/* the 4-bit window holding every set bit, as mask | column<<4, or 0xff */
+static uint8_t narrow(uint16_t diff) {
+    uint8_t column = 0;
+
+    if( diff == 0 ) return 0;
+    while( !(diff & 1) ) {
+        diff >>= 1;
+        column++;
+    }
+    if( diff > 0xf || column > 0xf ) return 0xff;
+    return diff | (column << 4);
+}
+
+static void takeState(RewindState *state) {
+    state->blocks = currentBlock | (heldBlock << 3);
+    for( uint8_t i=0; i<PREVIEW_COUNT; i++ ) {
+        state->queue[i] = previewQueue[i];
+    }
+    state->points = pointsCounter;
+    state->lvl = lvl;
+    state->random = randomState;
+}
+
+static void takeFloor() {
+    for( uint8_t i=0; i<REWIND_ROWS; i++ ) {
+        lastFloor[i] = FLOOR(REWIND_FIRST_ROW + i);
+    }
+}
+
+void rewindReset() {
+    ringHead = 0;
+    ringUsed = 0;
+    lastValid = FALSE;
+    used = FALSE;
+}
+
+void rewindPush() {
+    int8_t first = -1, last = -1;
+    uint8_t rows = 0, size;
+
+    if( lastValid == TRUE ) {
+        /* one run from the first to the last changed row */
+        for( uint8_t i=0; i<REWIND_ROWS; i++ ) {
+            uint16_t diff = lastFloor[i] ^ FLOOR(REWIND_FIRST_ROW + i);
+            if( diff == 0 ) continue;
+            if( first < 0 ) first = i;
+            last = i;
+            if( narrow(diff) == 0xff ) rows = ROWS_WIDE;
+        }
+        if( first >= 0 ) rows |= last - first + 1;
+        else first = 0;
+
+        /* drop the oldest entries until the new one fits */
+        size = entrySize(rows);
+        while( REWIND_BUFFER_SIZE - ringUsed < size ) {
+            ringUsed -= entrySize(ring[ringIndex(ringHead + REWIND_BUFFER_SIZE - ringUsed)]);
+        }
+
+        put(rows);
+        put(first);
+        for( uint8_t i=first; i<first + (rows & ROWS_COUNT); i++ ) {
+            uint16_t diff = lastFloor[i] ^ FLOOR(REWIND_FIRST_ROW + i);
+            if( rows & ROWS_WIDE ) put16(diff);
+            else put(narrow(diff));
+        }
+        put(lastState.blocks);
+        for( uint8_t i=0; i<PREVIEW_COUNT; i++ ) {
+            put(lastState.queue[i]);
+        }
+        put16(lastState.points);
+        put16(lastState.lvl);
+        put16(lastState.random);
+        put(rows);
+    }
+
+    takeFloor();
+    takeState(&lastState);
+    lastValid = TRUE;
+}
+
+uint8_t rewindUndo() {
+    uint16_t index;
+    uint8_t rows, first, blocks;
+
+    if( ringUsed == 0 ) return FALSE;
+
+    /* the newest entry ends right before the head */
+    rows = ring[ringIndex(ringHead + REWIND_BUFFER_SIZE - 1)];
+    index = ringIndex(ringHead + REWIND_BUFFER_SIZE - entrySize(rows));
+    ringHead = index;
+    ringUsed -= entrySize(rows);
+
+    get(&index);
+    first = get(&index);
+    for( uint8_t i=first; i<first + (rows & ROWS_COUNT); i++ ) {
+        uint16_t diff;
+        if( rows & ROWS_WIDE ) diff = get16(&index);
+        else {
+            uint8_t packed = get(&index);
+            diff = (uint16_t)(packed & 0xf) << (packed >> 4);
+        }
+        FLOOR(REWIND_FIRST_ROW + i) ^= diff;
+    }
+    blocks = get(&index);
+    currentBlock = blocks & 0x7;
+    heldBlock = blocks >> 3;
+    holdUsed = FALSE;               /* a fresh block may always be held */
+    for( uint8_t i=0; i<PREVIEW_COUNT; i++ ) {
+        previewQueue[i] = get(&index);
+    }
+    /* updatePoints() increments the counter and draws the digits */
+    pointsCounter = get16(&index) - 1;
+    lvl = get16(&index);
+    randomState = get16(&index);
+    updatePoints();
+
+    /* the restored spawn is the newest snapshot now */
+    takeFloor();
+    takeState(&lastState);
+    spawnBlock();
+    used = TRUE;
+    return TRUE;
+}
+
+uint8_t rewindUsed() {
+    return used;
+}
+
+#endif /* REWIND_ENABLE */
@@ -0,0 +1,82 @@
+/*
+ * @file Rewind.h
+ * @author: JZimnol
+ * @brief File containing optional practice mode: a ring buffer of board
+ *        snapshots that takes back blocks one at a time
+ */ 
+
+
+#ifndef REWIND_H_
+#define REWIND_H_
+
+#include "Config.h"
+
+#ifdef REWIND_ENABLE
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+/*
+ * @brief A snapshot is taken whenever a block locks. Each one is stored as
+ *        the difference to the next: the floor rows that the lock (cleared
+ *        rows, garbage) changed and the old block, queue, points and
+ *        generator state. The rows are stored as XOR with the newer row,
+ *        one byte each (4-bit mask and its column) when every change is at
+ *        most 4 columns wide, else two bytes. A lock without a clear takes
+ *        about 15 bytes, so the default buffer holds about 25 blocks; the
+ *        oldest ones are dropped to make room.
+ */
+#ifndef REWIND_BUFFER_SIZE
+    #define REWIND_BUFFER_SIZE  384   /* bytes */
+#endif
+#define REWIND_FIRST_ROW        (FLOOR_TOP + 1)     /* the top line is constant */
+#define REWIND_ROWS             (32 - REWIND_FIRST_ROW)
+
+#if REWIND_BUFFER_SIZE < 64
+    #error "REWIND_BUFFER_SIZE must hold an entry with every row changed"
+#endif
+
+/*************************************************************************\
+                                 MACROS
+\*************************************************************************/
+
+#define REWIND_RESET()          rewindReset()
+#define REWIND_PUSH()           rewindPush()
+#define REWIND_UNDO()           rewindUndo()
+#define REWIND_USED()           rewindUsed()
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief forget the snapshots of the previous game
+ */
+void rewindReset();
+/*
+ * @brief take a snapshot of the game; call when a new game starts and when
+ *        a block has locked and the next one has spawned
+ */
+void rewindPush();
+/*
+ * @brief go back to the spawn of the previous block, before any hold; the
+ *        time does not depend on the number of snapshots kept
+ * @return false if there is no older snapshot
+ */
+uint8_t rewindUndo();
+/*
+ * @brief check if a block was taken back in this game
+ * @return true if rewindUndo() succeeded since rewindReset()
+ */
+uint8_t rewindUsed();
+
+#else
+
+#define REWIND_RESET()
+#define REWIND_PUSH()
+#define REWIND_UNDO()           FALSE
+#define REWIND_USED()           FALSE
+
+#endif /* REWIND_ENABLE */
+
+#endif /* REWIND_H_ */
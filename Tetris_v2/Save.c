@@ -0,0 +1,145 @@
+/*
+ * @file Save.c
+ * @author: JZimnol
+ * @brief File containing definitions for game snapshot in EEPROM
+ */ 
+
+#include <stddef.h>
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+#include "Tetris.h"
+#include "Save.h"
+
+#ifdef SAVE_ENABLE
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static SaveImage saveSlots[2] EEMEM;
+static SaveImage pendingImage;
+static uint8_t pendingSlot = 0;         /* copy being written */
+static uint8_t pendingIndex = 0;        /* next byte to compare */
+static uint8_t pendingWrite = FALSE;
+static uint8_t lastSlot = 1;            /* newest complete copy */
+static uint8_t lastSequence = 0;
+static uint16_t lastContentCrc = 0;     /* skips snapshots that did not change */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/* CRC-16 of the image up to (not including) the given field offset */
+static uint16_t imageCrc(const SaveImage *image, uint8_t length) {
+    const uint8_t *data = (const uint8_t *)image;
+    uint16_t crc = 0xffff;
+    for( uint8_t i=0; i<length; i++ ) {
+        crc = _crc16_update(crc, data[i]);
+    }
+    return crc;
+}
+
+/* read one copy and check it */
+static uint8_t loadSlot(uint8_t slot, SaveImage *image) {
+    eeprom_read_block(image, &saveSlots[slot], sizeof(SaveImage));
+    if( image->magic != SAVE_MAGIC ) return FALSE;
+    return imageCrc(image, offsetof(SaveImage, crc)) == image->crc;
+}
+
+uint8_t saveRestore() {
+    SaveImage *image = &pendingImage;
+    uint8_t valid0 = loadSlot(0, image);
+    uint8_t sequence0 = image->sequence;
+    uint8_t valid1 = loadSlot(1, image);
+    uint8_t slot = 1;
+
+    if( valid0 == FALSE && valid1 == FALSE ) return FALSE;
+    /* sequence numbers wrap, so compare them by signed difference */
+    if( valid0 == TRUE && (valid1 == FALSE || (int8_t)(sequence0 - image->sequence) > 0) ) {
+        slot = 0;
+        loadSlot(0, image);
+    }
+    lastSlot = slot;
+    lastSequence = image->sequence;
+    lastContentCrc = imageCrc(image, offsetof(SaveImage, sequence));
+
+    framebufferInit();
+    for( uint8_t i=0; i<SAVE_FLOOR_ROWS; i++ ) {
+        FLOOR(SAVE_FLOOR_FIRST + i) = image->floor[i];
+    }
+    currentBlock = image->currentBlock;
+    for( uint8_t i=0; i<PREVIEW_COUNT; i++ ) {
+        previewQueue[i] = image->queue[i];
+    }
+    heldBlock = image->heldBlock;
+    holdUsed = image->holdUsed;
+    randomState = image->random;
+
+    /* updatePoints() increments the counter and draws the digits */
+    lvl = image->lvl;
+    pointsCounter = image->points - 1;
+    updatePoints();
+
+    spawnBlock();
+    return TRUE;
+}
+
+void saveRequest() {
+    SaveImage *image = &pendingImage;
+    uint16_t contentCrc;
+
+    image->magic = SAVE_MAGIC;
+    for( uint8_t i=0; i<SAVE_FLOOR_ROWS; i++ ) {
+        image->floor[i] = FLOOR(SAVE_FLOOR_FIRST + i);
+    }
+    image->currentBlock = currentBlock;
+    for( uint8_t i=0; i<PREVIEW_COUNT; i++ ) {
+        image->queue[i] = previewQueue[i];
+    }
+    image->heldBlock = heldBlock;
+    image->holdUsed = holdUsed;
+    image->points = pointsCounter;
+    image->lvl = lvl;
+    image->random = randomState;
+
+    contentCrc = imageCrc(image, offsetof(SaveImage, sequence));
+    if( pendingWrite == FALSE && contentCrc == lastContentCrc ) return;
+    lastContentCrc = contentCrc;
+
+    /* never overwrite the newest complete copy */
+    image->sequence = lastSequence + 1;
+    image->crc = imageCrc(image, offsetof(SaveImage, crc));
+    pendingSlot = lastSlot ^ 1;
+    pendingIndex = 0;
+    pendingWrite = TRUE;
+}
+
+void savePoll() {
+    const uint8_t *data = (const uint8_t *)&pendingImage;
+    uint8_t *target = (uint8_t *)&saveSlots[pendingSlot];
+
+    if( pendingWrite == FALSE || !eeprom_is_ready() ) return;
+
+    /* reading is fast; only bytes that differ cost a 3.4 ms write cycle */
+    while( pendingIndex < sizeof(SaveImage) ) {
+        uint8_t i = pendingIndex++;
+        if( eeprom_read_byte(target + i) != data[i] ) {
+            eeprom_write_byte(target + i, data[i]);
+            return;
+        }
+    }
+
+    pendingWrite = FALSE;
+    lastSlot = pendingSlot;
+    lastSequence = pendingImage.sequence;
+}
+
+void saveInvalidate() {
+    pendingWrite = FALSE;
+    lastContentCrc = 0;
+    eeprom_update_byte(&saveSlots[0].magic, 0xff);
+    eeprom_update_byte(&saveSlots[1].magic, 0xff);
+}
+
+#endif /* SAVE_ENABLE */
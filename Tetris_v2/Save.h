@@ -0,0 +1,86 @@
+/*
+ * @file Save.h
+ * @author: JZimnol
+ * @brief File containing game snapshot kept in EEPROM for resume after power off
+ */ 
+
+
+#ifndef SAVE_H_
+#define SAVE_H_
+
+#include "Config.h"
+
+#ifdef SAVE_ENABLE
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+
+#define SAVE_MAGIC          (0x50 + PREVIEW_COUNT)   /* changes with the layout */
+#define SAVE_FLOOR_FIRST    8                        /* rows above are constant */
+#define SAVE_FLOOR_ROWS     (32 - SAVE_FLOOR_FIRST)
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Snapshot of a game taken when a block spawns. Two copies are kept
+ *        and written alternately, the crc is written last, so a write cut by
+ *        power loss leaves the older copy valid.
+ */
+typedef struct {
+    uint8_t magic;
+    uint16_t floor[SAVE_FLOOR_ROWS];
+    uint8_t currentBlock;
+    uint8_t queue[PREVIEW_COUNT];
+    uint8_t heldBlock;
+    uint8_t holdUsed;
+    uint16_t points;
+    uint16_t lvl;
+    uint16_t random;
+    uint8_t sequence;           /* newer copy wins */
+    uint16_t crc;               /* CRC-16 of all fields above */
+} SaveImage;
+
+/*************************************************************************\
+                                 MACROS
+\*************************************************************************/
+
+#define SAVE_RESTORE()      saveRestore()
+#define SAVE_REQUEST()      saveRequest()
+#define SAVE_POLL()         savePoll()
+#define SAVE_INVALIDATE()   saveInvalidate()
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief load the newest valid snapshot and continue that game
+ * @return true if a game was resumed
+ */
+uint8_t saveRestore();
+/*
+ * @brief take a snapshot of the game; it is written later by savePoll()
+ */
+void saveRequest();
+/*
+ * @brief write at most one changed byte of a pending snapshot; never waits
+ *        for the EEPROM, call from the main loop
+ */
+void savePoll();
+/*
+ * @brief drop both copies, so the next power up starts a new game
+ */
+void saveInvalidate();
+
+#else
+
+#define SAVE_RESTORE()      FALSE
+#define SAVE_REQUEST()
+#define SAVE_POLL()
+#define SAVE_INVALIDATE()
+
+#endif /* SAVE_ENABLE */
+
+#endif /* SAVE_H_ */
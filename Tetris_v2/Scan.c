@@ -0,0 +1,99 @@
+/*
+ * @file Scan.c
+ * @author: JZimnol
+ * @brief File containing definitions for adaptive display scanner
+ */ 
+
+#include <avr/io.h>
+#include "Tetris.h"
+#include "Scan.h"
+
+#ifdef SCAN_SKIP_BLANK_ROWS
+
+/* the row has to be shifted out before the shortest slot ends */
+_Static_assert(DISPLAY_ROW_CYCLES < SCAN_MIN_ON_CYCLES, "too many chained panels for SCAN_MAX_PASSES");
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static uint8_t litRows[32];             /* indexes of non-zero rows in this frame */
+static uint8_t litCount = 0;
+static uint8_t litIndex = 0;            /* next entry of litRows in this pass */
+static uint8_t passesLeft = 0;
+static uint8_t onTicks = SCAN_SLOT_TICKS;
+static uint16_t blankTicks = 0;         /* dark time after every pass */
+static uint16_t blankLeft = 0;
+static uint8_t blankLatched = FALSE;
+static uint16_t elapsedTicks = 0;       /* ticks not converted to slots yet */
+static uint8_t periodTicks = SCAN_SLOT_TICKS;   /* length of the slot just ended */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/* find lit rows and split the frame into passes of equal length */
+static void startFrame() {
+    uint8_t passes = 1;
+
+    litCount = 0;
+    for( uint8_t i=0; i<32; i++ ) {
+        uint16_t lit = frameBuffer.main[i];
+#if DISPLAY_PANELS > 1
+        /* rows are shared, a row is lit if any panel uses it */
+        for( uint8_t panel=0; panel<DISPLAY_PANELS - 1; panel++ ) {
+            lit |= panelMain[panel][i];
+        }
+#endif
+        if( lit != 0 ) litRows[litCount++] = i;
+    }
+
+    /* spend the time of blank rows on extra passes over the lit ones */
+    while( passes < SCAN_MAX_PASSES && (litCount * passes * 2) <= 32 ) {
+        passes <<= 1;
+    }
+    onTicks = SCAN_SLOT_TICKS / passes;
+    /* the rest of every pass is dark, which keeps each row at 1/32 duty */
+    blankTicks = (uint16_t)(32 - litCount) * SCAN_SLOT_TICKS / passes;
+    passesLeft = passes;
+}
+
+uint8_t scanNextRow() {
+    uint8_t period;
+    uint8_t slots;
+
+    elapsedTicks += periodTicks;
+    slots = elapsedTicks / SCAN_SLOT_TICKS;
+    elapsedTicks %= SCAN_SLOT_TICKS;
+
+    if( litIndex == litCount && blankLeft == 0 ) {
+        if( passesLeft == 0 ) startFrame();
+        passesLeft--;
+        litIndex = 0;
+        blankLeft = blankTicks;
+        blankLatched = FALSE;
+    }
+
+    if( litIndex < litCount ) {
+        /* OCR0A has to be written before TCNT0 passes it, so before SPI */
+        period = onTicks;
+        OCR0A = period - 1;
+        iteratorSPI = litRows[litIndex++];
+        SPI_MasterTransmitRow(iteratorSPI);
+    }
+    else {
+        /* a dark gap may be longer than Timer0 can count, so split it */
+        period = blankLeft > 255 ? 255 : blankLeft;
+        blankLeft -= period;
+        OCR0A = period - 1;
+        if( blankLatched == FALSE ) {
+            SPI_MasterTransmitBlank();
+            blankLatched = TRUE;
+        }
+    }
+    periodTicks = period;
+
+    return slots;
+}
+
+#endif /* SCAN_SKIP_BLANK_ROWS */
@@ -0,0 +1,54 @@
+/*
+ * @file Scan.h
+ * @author: JZimnol
+ * @brief File containing adaptive display scanner that skips blank rows
+ */ 
+
+
+#ifndef SCAN_H_
+#define SCAN_H_
+
+#include "Config.h"
+
+#ifdef SCAN_SKIP_BLANK_ROWS
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+/*
+ * @brief Timer0 runs at fck/256 (32 us per tick). A row slot of the plain
+ *        scanner is 16 ticks (0.512 ms), so one frame is 512 ticks long.
+ */
+#define SCAN_SLOT_TICKS     16
+#define SCAN_FRAME_TICKS    (32 * SCAN_SLOT_TICKS)
+/*
+ * @brief Maximum number of passes over the lit rows per frame. The shortest
+ *        on-time is SCAN_SLOT_TICKS / SCAN_MAX_PASSES ticks and has to be
+ *        longer than one ISR (~110 us with SPI at fck/16); Scan.c checks the
+ *        row transfer of the chained panels against it.
+ */
+#ifndef SCAN_MAX_PASSES
+    #define SCAN_MAX_PASSES 2
+#endif
+#define SCAN_MIN_ON_CYCLES  (SCAN_SLOT_TICKS / SCAN_MAX_PASSES * 256UL)
+
+#if (SCAN_MAX_PASSES != 1) && (SCAN_MAX_PASSES != 2) && (SCAN_MAX_PASSES != 4)
+    #error "SCAN_MAX_PASSES must be 1, 2 or 4"
+#endif
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief show the next lit row (or blank the display) and program the length
+ *        of its slot into OCR0A; call from the Timer0 compare ISR.
+ *        Every lit row is on for SCAN_SLOT_TICKS per frame no matter how many
+ *        rows are lit, so the brightness does not depend on the content.
+ * @return number of whole 0.512 ms slots elapsed since the previous call
+ */
+uint8_t scanNextRow();
+
+#endif /* SCAN_SKIP_BLANK_ROWS */
+
+#endif /* SCAN_H_ */
@@ -0,0 +1,114 @@
+/*
+ * @file Scheduler.c
+ * @author: JZimnol
+ * @brief File containing definitions for the cooperative task scheduler
+ */ 
+
+#include <avr/io.h>
+#include "Tetris.h"
+#include "Scheduler.h"
+#include "Tick.h"
+#include "Watchdog.h"
+#ifdef TELEMETRY_ENABLE
+    #include "Telemetry.h"
+#endif
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+#ifdef TELEMETRY_ENABLE
+static uint8_t schedNextId = 0;         /* task sent in next packet */
+static uint8_t sendPending = FALSE;     /* period elapsed, packet not queued yet */
+#endif
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+void schedInit() {
+    uint32_t now = tickNow();
+
+    for( uint8_t i=0; i<TASK_COUNT; i++ ) {
+        Task *task = &tasks[i];
+        task->release = now;
+        task->stats.runs = 0;
+        task->stats.overruns = 0;
+        task->stats.skipped = 0;
+        task->stats.worstLateness = 0;
+        task->stats.worstDuration = 0;
+        task->stats.dropped = 0;
+    }
+#ifdef TELEMETRY_ENABLE
+    tickTimerStartPeriodic(TIMER_SCHED, SCHED_STREAM_PERIOD);
+#endif
+}
+
+void schedRun() {
+    uint32_t start = tickNow();
+
+    for( uint8_t i=0; i<TASK_COUNT; i++ ) {
+        Task *task = &tasks[i];
+        uint32_t lateness, finish;
+
+        if( task->enabled == FALSE ) continue;
+        /* signed difference keeps working when the counter wraps */
+        if( (int32_t)(start - task->release) < 0 ) continue;
+
+        lateness = start - task->release;
+        /* saturate, a stall of more than 33 s must not wrap to a small value */
+        if( lateness > task->stats.worstLateness ) task->stats.worstLateness = lateness > 0xffff ? 0xffff : lateness;
+        WATCHDOG_TASK(i);
+        task->run(task);
+        WATCHDOG_TASK(WATCHDOG_IDLE);
+        task->stats.runs++;
+
+        finish = tickNow();
+        if( finish - start > task->stats.worstDuration ) task->stats.worstDuration = finish - start > 0xffff ? 0xffff : finish - start;
+        if( finish - task->release > task->deadline ) task->stats.overruns++;
+
+        if( lateness >= task->period ) {
+            /* do not run the lost periods back to back, restart the schedule */
+            if( task->period != 0 ) task->stats.skipped += lateness / task->period;
+            task->release = start + task->period;
+        }
+        else {
+            task->release += task->period;
+        }
+        /* one task per call, so the input task is checked between any two others */
+        return;
+    }
+}
+
+void schedResume(uint8_t id) {
+    tasks[id].release = tickNow() + tasks[id].period;
+    tasks[id].enabled = TRUE;
+}
+
+void schedSuspend(uint8_t id) {
+    tasks[id].enabled = FALSE;
+}
+
+void schedReport() {
+#ifdef TELEMETRY_ENABLE
+    uint8_t packet[1 + sizeof(TaskStats)];
+    const uint8_t *src = (const uint8_t *)&tasks[schedNextId].stats;
+
+    if( sendPending == FALSE ) {
+        if( tickTimerExpired(TIMER_SCHED) == FALSE ) return;
+        sendPending = TRUE;
+    }
+
+    packet[0] = schedNextId;
+    for( uint8_t i=0; i<sizeof(TaskStats); i++ ) {
+        packet[i + 1] = src[i];
+    }
+
+    /* on a full buffer keep the same entry and retry on the next poll */
+    if( telemetrySendPacket(PACKET_TASK, packet, sizeof(packet)) == TRUE ) {
+        sendPending = FALSE;
+        schedNextId++;
+        if( schedNextId == TASK_COUNT ) schedNextId = 0;
+    }
+#endif
+}
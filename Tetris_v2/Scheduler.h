@@ -0,0 +1,93 @@
+/*
+ * @file Scheduler.h
+ * @author: JZimnol
+ * @brief File containing cooperative task scheduler with deadline monitoring
+ */ 
+
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include "Config.h"
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+
+#define SCHED_STREAM_PERIOD     128   /* ticks (~65 ms) between packets, one task each */
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Tasks in priority order; the first due task runs first
+ */
+typedef enum {
+    TASK_INPUT      = (uint8_t)0,    /* buttons */
+    TASK_GRAVITY    = (uint8_t)1,    /* fall of the block (the whole logic tick with LOGIC_TICK_ENABLE) */
+    TASK_ANIMATION  = (uint8_t)2,    /* keyframe sequences */
+    TASK_RENDER     = (uint8_t)3,    /* composes the changed frame */
+    TASK_BACKGROUND = (uint8_t)4,    /* EEPROM writer, versus link and sound */
+    TASK_TELEMETRY  = (uint8_t)5,    /* USART streams */
+    TASK_COUNT      = (uint8_t)6
+} TaskId;
+/*
+ * @brief Timing of one task in 0.512 ms ticks; sent with the task id in
+ *        PACKET_TASK payload when telemetry is enabled
+ */
+typedef struct {
+    uint32_t runs;
+    uint16_t overruns;          /* runs finished later than the deadline */
+    uint16_t skipped;           /* whole periods lost, the schedule restarts after them */
+    uint16_t worstLateness;     /* longest delay from release to start */
+    uint16_t worstDuration;     /* longest run */
+    uint16_t dropped;           /* work the task had to discard (full queues) */
+} TaskStats;
+/*
+ * @brief One task. The body runs from the top on every release and must
+ *        return after a bounded amount of work.
+ */
+typedef struct Task {
+    void (*run)(struct Task *task);
+    uint16_t period;            /* ticks between releases, the body may change it */
+    uint16_t deadline;          /* ticks from release to the end of the run */
+    uint8_t enabled;
+    uint32_t release;           /* tick count of the next release */
+    TaskStats stats;
+} Task;
+
+/*************************************************************************\
+                            VARIABLE DECLARATIONS
+\*************************************************************************/
+
+extern Task tasks[TASK_COUNT];  /* defined by the application (main.c) */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief release every enabled task now and clear the statistics
+ */
+void schedInit();
+/*
+ * @brief run the first due task in priority order; call from the main loop
+ */
+void schedRun();
+/*
+ * @brief start a task; its first release is one period from now
+ * @param task id
+ */
+void schedResume(uint8_t id);
+/*
+ * @brief stop releasing a task
+ * @param task id
+ */
+void schedSuspend(uint8_t id);
+/*
+ * @brief send the statistics of the next task when the stream period
+ *        elapsed; call from the telemetry task
+ */
+void schedReport();
+
+#endif /* SCHEDULER_H_ */
@@ -0,0 +1,174 @@
+/*
+ * @file Sound.c
+ * @author: JZimnol
+ * @brief File containing definitions for music and sound effects on Timer1
+ */ 
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "Tetris.h"
+#include "Sound.h"
+#include "Tick.h"
+
+#ifdef SOUND_ENABLE
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+
+#define A3  SOUND_TONE(220)
+#define A4  SOUND_TONE(440)
+#define B4  SOUND_TONE(494)
+#define C5  SOUND_TONE(523)
+#define D5  SOUND_TONE(587)
+#define E5  SOUND_TONE(659)
+#define F5  SOUND_TONE(698)
+#define G5  SOUND_TONE(784)
+#define A5  SOUND_TONE(880)
+#define C6  SOUND_TONE(1047)
+#define E6  SOUND_TONE(1319)
+#define G6  SOUND_TONE(1568)
+#define C7  SOUND_TONE(2093)
+#define G3  SOUND_TONE(196)
+
+#define Q   TICKS_FROM_MS(400)      /* quarter note */
+#define E   (Q / 2)                 /* eighth note */
+#define QD  (Q + E)                 /* dotted quarter */
+
+/*************************************************************************\
+                                  TABLES
+\*************************************************************************/
+
+/* Korobeiniki, both parts, repeated while the game is played */
+static const Note musicNotes[] PROGMEM = {
+    { E5, Q  }, { B4, E  }, { C5, E  }, { D5, Q  }, { C5, E  }, { B4, E  },
+    { A4, Q  }, { A4, E  }, { C5, E  }, { E5, Q  }, { D5, E  }, { C5, E  },
+    { B4, QD }, { C5, E  }, { D5, Q  }, { E5, Q  },
+    { C5, Q  }, { A4, Q  }, { A4, Q  }, { SOUND_REST, Q },
+    { SOUND_REST, E }, { D5, Q }, { F5, E }, { A5, Q  }, { G5, E  }, { F5, E  },
+    { E5, QD }, { C5, E  }, { E5, Q  }, { D5, E  }, { C5, E  },
+    { B4, Q  }, { B4, E  }, { C5, E  }, { D5, Q  }, { E5, Q  },
+    { C5, Q  }, { A4, Q  }, { A4, Q  }, { SOUND_REST, Q },
+    { 0, 0 }
+};
+
+static const Note lockNotes[] PROGMEM = {
+    { G3, TICKS_FROM_MS(40) },
+    { 0, 0 }
+};
+
+static const Note lineClearNotes[] PROGMEM = {
+    { C6, TICKS_FROM_MS(60) },
+    { E6, TICKS_FROM_MS(60) },
+    { G6, TICKS_FROM_MS(60) },
+    { C7, TICKS_FROM_MS(120) },
+    { 0, 0 }
+};
+
+static const Note gameOverNotes[] PROGMEM = {
+    { E5, TICKS_FROM_MS(200) },
+    { D5, TICKS_FROM_MS(200) },
+    { C5, TICKS_FROM_MS(200) },
+    { B4, TICKS_FROM_MS(200) },
+    { A4, TICKS_FROM_MS(200) },
+    { A3, TICKS_FROM_MS(600) },
+    { 0, 0 }
+};
+
+/* indexed by SoundEffect */
+static const Note * const effects[] PROGMEM = {
+    lockNotes,
+    lineClearNotes,
+    gameOverNotes
+};
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static const Note *musicNote = musicNotes;  /* next note of the music */
+static const Note *effectNote = NULL;       /* next note of the effect, NULL when idle */
+static uint8_t musicOn = FALSE;
+static uint8_t gapPending = FALSE;          /* the sounding note still has its gap to play */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+static void toneOut(uint16_t tone) {
+    if( tone == SOUND_REST ) {
+        TCCR1A = 0;                 /* PB1 is a plain output again */
+        PORTB &= ~(1<<PB1);
+        return;
+    }
+    OCR1A = tone;
+    /* a counter above a lower new top would run to 0xffff first */
+    TCNT1 = 0;
+    TCCR1A = (1<<COM1A0);           /* toggle OC1A on compare match */
+}
+
+/* let the next poll pick the new sequence at once */
+static void soundKick() {
+    gapPending = FALSE;
+    tickTimerStart(TIMER_SOUND, 0);
+}
+
+void soundInit() {
+    DDRB |= (1<<PB1);
+    PORTB &= ~(1<<PB1);
+    TCCR1A = 0;
+    TCCR1B = (1<<WGM12) | (1<<CS11);    /* CTC on OCR1A, fck/8 */
+    TIMSK1 = 0;                         /* no interrupts, the wave is made by the timer */
+}
+
+void soundPoll() {
+    const Note *note;
+    uint16_t ticks;
+
+    if( tickTimerExpired(TIMER_SOUND) == FALSE ) return;
+
+    /* a short silence between notes, so repeated notes are heard as two */
+    if( gapPending == TRUE ) {
+        gapPending = FALSE;
+        toneOut(SOUND_REST);
+        tickTimerStart(TIMER_SOUND, SOUND_GAP_TICKS);
+        return;
+    }
+
+    note = effectNote;
+    if( note == NULL && musicOn == TRUE ) note = musicNote;
+    if( note == NULL ) {
+        toneOut(SOUND_REST);        /* the timer stays stopped until a kick */
+        return;
+    }
+
+    ticks = pgm_read_word(&note->ticks);
+    if( ticks == 0 ) {
+        /* end of a sequence: the effect gives way to the music, the music loops */
+        if( note == effectNote ) effectNote = NULL;
+        else musicNote = musicNotes;
+        tickTimerStart(TIMER_SOUND, 0);
+        return;
+    }
+
+    toneOut(pgm_read_word(&note->tone));
+    tickTimerStart(TIMER_SOUND, ticks - SOUND_GAP_TICKS);
+    gapPending = TRUE;
+    if( note == effectNote ) effectNote++;
+    else musicNote++;
+}
+
+void soundEffect(uint8_t id) {
+    effectNote = pgm_read_ptr(&effects[id]);
+    soundKick();
+}
+
+void soundMusic(uint8_t command) {
+    /* resuming a running music would cut its note */
+    if( command == MUSIC_RESUME && musicOn == TRUE ) return;
+    if( command == MUSIC_START ) musicNote = musicNotes;
+    musicOn = (command != MUSIC_OFF);
+    if( effectNote == NULL ) soundKick();
+}
+
+#endif /* SOUND_ENABLE */
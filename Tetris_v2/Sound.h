@@ -0,0 +1,99 @@
+/*
+ * @file Sound.h
+ * @author: JZimnol
+ * @brief File containing optional music and sound effects on Timer1 (OC1A)
+ */ 
+
+
+#ifndef SOUND_H_
+#define SOUND_H_
+
+#include "Config.h"
+
+#ifdef SOUND_ENABLE
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+/*
+ * @brief Timer1 runs in CTC mode at F_CPU/8 and toggles OC1A (PB1) on every
+ *        compare match, so the square wave is made by the hardware and no
+ *        interrupt is used. Software only changes OCR1A once per note.
+ */
+#define SOUND_PRESCALER     8
+#define SOUND_TONE(hz)      ((uint16_t)(F_CPU / (2UL * SOUND_PRESCALER * (hz)) - 1))
+#define SOUND_REST          0       /* output disconnected, PB1 low */
+#define SOUND_GAP_TICKS     16      /* ~8 ms of silence at the end of a note */
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief One note of a sequence in flash; ticks == 0 ends the sequence
+ */
+typedef struct {
+    uint16_t tone;                  /* OCR1A value from SOUND_TONE() or SOUND_REST */
+    uint16_t ticks;                 /* length including the gap */
+} Note;
+/*
+ * @brief Effects; a triggered effect replaces the one that is playing and
+ *        the music continues after it
+ */
+typedef enum {
+    SOUND_LOCK       = (uint8_t)0,    /* block landed */
+    SOUND_LINE_CLEAR = (uint8_t)1,    /* rising arpeggio */
+    SOUND_GAME_OVER  = (uint8_t)2     /* falling line */
+} SoundEffect;
+/*
+ * @brief Music commands
+ */
+typedef enum {
+    MUSIC_OFF    = (uint8_t)0,      /* stop, the position is kept */
+    MUSIC_START  = (uint8_t)1,      /* play from the first note */
+    MUSIC_RESUME = (uint8_t)2       /* play from the kept position */
+} MusicCommand;
+
+/*************************************************************************\
+                                 MACROS
+\*************************************************************************/
+
+#define SOUND_INIT()                soundInit()
+#define SOUND_POLL()                soundPoll()
+#define SOUND_EFFECT(id)            soundEffect(id)
+#define SOUND_MUSIC(command)        soundMusic(command)
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief set up Timer1 and PB1; call after DISPLAY_INIT(), which writes DDRB
+ */
+void soundInit();
+/*
+ * @brief start the next note when the current one is over; at most one note
+ *        per call (a few flash reads and register writes); call from the
+ *        main loop
+ */
+void soundPoll();
+/*
+ * @brief play an effect
+ * @param SoundEffect
+ */
+void soundEffect(uint8_t id);
+/*
+ * @brief control the music
+ * @param MusicCommand
+ */
+void soundMusic(uint8_t command);
+
+#else
+
+#define SOUND_INIT()
+#define SOUND_POLL()
+#define SOUND_EFFECT(id)
+#define SOUND_MUSIC(command)
+
+#endif /* SOUND_ENABLE */
+
+#endif /* SOUND_H_ */
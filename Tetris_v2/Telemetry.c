@@ -0,0 +1,39 @@
+/*
+ * @file Telemetry.c
+ * @author: JZimnol
+ * @brief File containing definitions for framed packet protocol
+ */ 
+
+#include <avr/io.h>
+#include <util/crc16.h>
+#include "Tetris.h"
+#include "Usart.h"
+#include "Telemetry.h"
+
+#ifdef TELEMETRY_ENABLE
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+uint8_t telemetrySendPacket(uint8_t type, const void *payload, uint8_t length) {
+    const uint8_t *data = payload;
+    uint8_t crc = 0;
+
+    /* packets are never split, so the host can always resynchronize */
+    if( USART_TxFree() < length + TELEMETRY_OVERHEAD ) return FALSE;
+
+    USART_Transmit(TELEMETRY_SYNC);
+    USART_Transmit(type);
+    crc = _crc8_ccitt_update(crc, type);
+    USART_Transmit(length);
+    crc = _crc8_ccitt_update(crc, length);
+    for( uint8_t i=0; i<length; i++ ) {
+        USART_Transmit(data[i]);
+        crc = _crc8_ccitt_update(crc, data[i]);
+    }
+    USART_Transmit(crc);
+    return TRUE;
+}
+
+#endif /* TELEMETRY_ENABLE */
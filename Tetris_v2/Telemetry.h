@@ -0,0 +1,49 @@
+/*
+ * @file Telemetry.h
+ * @author: JZimnol
+ * @brief File containing framed packet protocol used to stream data over USART
+ */ 
+
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include "Config.h"
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+/*
+ * @brief Packet layout (all multi-byte fields little endian):
+ *        SYNC | type | length | payload[length] | CRC-8 (type, length, payload)
+ */
+#define TELEMETRY_SYNC          0x7e
+#define TELEMETRY_OVERHEAD      4         /* sync, type, length and crc bytes */
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Types of packets
+ */
+typedef enum {
+    PACKET_PROFILE     = (uint8_t)'P',
+    PACKET_FRAME_DELTA = (uint8_t)'F',
+    PACKET_MEMORY      = (uint8_t)'M',
+    PACKET_TASK        = (uint8_t)'T',
+    PACKET_REMOTE_INPUT  = (uint8_t)'I',    /* host to board, see Remote.h */
+    PACKET_REMOTE_STATUS = (uint8_t)'S'     /* both ways, see Remote.h */
+} PacketType;
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief queue one packet; the packet is dropped as a whole if it does not fit
+ * @param packet type, payload pointer and payload length
+ * @return true if queued, false if the transmit buffer is too full
+ */
+uint8_t telemetrySendPacket(uint8_t type, const void *payload, uint8_t length);
+
+#endif /* TELEMETRY_H_ */
@@ -5,7 +5,19 @@
  */ 
 
 #include <avr/io.h>   
+#include <avr/pgmspace.h>
 #include "Tetris.h"
+#include "Profiler.h"
+#include "Scan.h"
+#include "Tick.h"
+#include "Save.h"
+#include "Blocks.h"
+#include "Versus.h"
+#include "Game.h"
+#include "Sound.h"
+#include "Display.h"
+#include "Bitmap.h"
+#include "Rewind.h"
 
 /*************************************************************************\
                                  VARIABLES
@@ -14,19 +26,118 @@
 FrameBuffer frameBuffer;
 Coordinates coords = {8, 8};
 
-BlockType nextBlock = 0;
+BlockType previewQueue[PREVIEW_COUNT];
 BlockType currentBlock = 0;
+uint8_t blockRotation = 0;
+BlockType heldBlock = NO_BLOCK;
+uint8_t holdUsed = FALSE;
+uint16_t randomState = 1;
 
 uint16_t lvl = 0;
 uint16_t pointsCounter = 0;
-volatile uint16_t timer_ms = 0;
 volatile uint8_t iteratorSPI = 0;
-volatile uint16_t debounce = 0;
+#if DISPLAY_PANELS > 1
+uint16_t panelMain[DISPLAY_PANELS - 1][32];
+#endif
+uint8_t frameDirty = FALSE;
+uint8_t frameHeld = FALSE;
+uint8_t gameOver = FALSE;
+
+/*************************************************************************\
+                                  TABLES
+\*************************************************************************/
+
+#ifdef HOLD_ENABLE
+    #define OVERLAY_SLOTS_USED  (PREVIEW_COUNT + 1)
+#else
+    #define OVERLAY_SLOTS_USED  PREVIEW_COUNT
+#endif
+
+#if (PREVIEW_COUNT < 1) || (OVERLAY_SLOTS_USED > 2)
+    #error "only two 4x2 piece slots fit next to the score"
+#endif
+
+/* all rotation states of all blocks, indexed by BlockType (see Blocks.h) */
+static const uint16_t blockRotations[NO_BLOCK + 1][4] PROGMEM = BLOCK_ROTATIONS;
+
+/* top overlay row of every slot; previews first, hold slot last */
+static const uint8_t overlaySlotRow[2] PROGMEM = { 3, 0 };
+
+/* 3x5 digits of the score, bit 2 is the leftmost column */
+static const uint8_t digitFont[10][5] PROGMEM = {
+    { 7, 5, 5, 5, 7 },
+    { 2, 6, 2, 2, 7 },
+    { 7, 1, 7, 4, 7 },
+    { 7, 1, 7, 1, 7 },
+    { 5, 5, 7, 1, 1 },
+    { 7, 4, 7, 1, 7 },
+    { 7, 4, 7, 5, 7 },
+    { 7, 5, 1, 1, 1 },
+    { 7, 5, 7, 5, 7 },
+    { 7, 5, 7, 1, 7 }
+};
+
+_Static_assert(sizeof(FrameBuffer) <= FRAMEBUFFER_BUDGET, "frame buffer over its SRAM budget");
+/* leave at least half of every 0.512 ms row slot (4096 cycles) to the game */
+_Static_assert(DISPLAY_PANELS >= 1 && DISPLAY_ROW_CYCLES <= 2048, "too many chained panels");
 
 /*************************************************************************\
                                  FUNCTIONS
 \*************************************************************************/
 
+/* xorshift generator used to fill the preview queue */
+static BlockType randomBlock() {
+    randomState ^= randomState<<7;
+    randomState ^= randomState>>9;
+    randomState ^= randomState<<8;
+    return randomState % 7;
+}
+
+/* draw rows dy = 0..1 of the spawn shape into the overlay rows of one slot */
+static void drawPiece(uint8_t slot, BlockType type) {
+    uint8_t row = pgm_read_byte(&overlaySlotRow[slot]);
+    uint16_t shape = pgm_read_word(&blockRotations[type][0]);
+    frameBuffer.main[row] |= BOX_ROW(shape, 0);
+    frameBuffer.main[row + 1] |= BOX_ROW(shape, 1);
+}
+
+/* push the floor up and fill the bottom with rows that have one common hole */
+static void addGarbage(uint8_t lines) {
+#ifdef VERSUS_ENABLE
+    uint8_t toppedOut = FALSE;
+    uint16_t garbage;
+
+    if( lines == 0 ) return;
+    if( lines > 24 ) lines = 24;
+    /* the generator state is only read, the block sequence does not change */
+    garbage = 0xffff & ~(1 << (2 + randomState % 12));
+
+    for( uint8_t i=8; i<8 + lines; i++ ) {
+        if( FLOOR(i) != 0xc003 ) toppedOut = TRUE;
+    }
+    for( uint8_t i=8; i + lines<32; i++ ) {
+        FLOOR(i) = FLOOR(i + lines);
+    }
+    for( uint8_t i=32 - lines; i<32; i++ ) {
+        FLOOR(i) = garbage;
+    }
+    if( toppedOut == TRUE ) GameOver();
+#endif
+}
+
+/* one pixel row of three 3x5 digits, hundreds in the leftmost columns */
+static uint16_t digitRow(const uint8_t digits[3], uint8_t i) {
+    return (uint16_t)pgm_read_byte(&digitFont[digits[0]][i])<<13 |
+           (uint16_t)pgm_read_byte(&digitFont[digits[1]][i])<<9 |
+           (uint16_t)pgm_read_byte(&digitFont[digits[2]][i])<<5;
+}
+
+/* playfield row; everything outside of rows 7..31 is solid */
+static uint16_t floorAt(uint8_t row) {
+    if( row < FLOOR_TOP || row > 31 ) return 0xffff;
+    return FLOOR(row);
+}
+
 void SPI_MasterInit() {
     /* Set MOSI, CS and SCK output, all others input */
     DDRB = (1<<PB3) | (1<<PB5) | (1<<PB2);
@@ -64,61 +175,100 @@ void SPI_MasterTransmit_32bit(uint32_t data_bytes) {
     LT_OFF;     /* Latch off the transmission */
 }
 
+void SPI_MasterTransmitRow(uint8_t row) {
+#if DISPLAY_PANELS > 1
+    /* the farthest panel has to be shifted in first */
+    for( uint8_t panel=DISPLAY_PANELS - 1; panel>0; panel-- ) {
+        SPI_MasterTransmit_16bit(~panelMain[panel - 1][row]);
+    }
+#endif
+    SPI_MasterTransmit_16bit(~frameBuffer.main[row]);
+    /* 0x80000000 == 0b10000000000000000000000000000000 */
+    SPI_MasterTransmit_32bit(0x80000000>>row);
+}
+
+void SPI_MasterTransmitBlank() {
+    for( uint8_t panel=0; panel<DISPLAY_PANELS; panel++ ) {
+        SPI_MasterTransmit_16bit(0xffff);     /* all columns off */
+    }
+    SPI_MasterTransmit_32bit(0);              /* no row selected */
+}
+
 void TIM0_Init() {
     TCCR0A = (1<<WGM01);              /* set CTC mode */
+#ifdef SCAN_SKIP_BLANK_ROWS
+    TCCR0B = (1<<CS02);               /* set fck/256, slot length set by scanner */
+    OCR0A  = SCAN_SLOT_TICKS - 1;
+#else
     TCCR0B = (1<<CS00) | (1<<CS02);   /* set fck/1024 */
     OCR0A  = 3;
+#endif
     TIMSK0 = (1<<OCIE0A);
 }
 
 void deleteLevel() {
+    PROFILE_BEGIN(PROF_DELETE_LEVEL);
     uint8_t i=31;
+    uint8_t cleared = 0;
+#ifdef CLEAR_ANIMATION_ENABLE
+    uint32_t clearedRows = 0;
+#endif
     while( i>7 ) {
-        if( frameBuffer.floor[i] == 0xffff ) {
+        if( FLOOR(i) == 0xffff ) {
+#ifdef CLEAR_ANIMATION_ENABLE
+            clearedRows |= (uint32_t)1<<(i - cleared);     /* position before the collapse */
+#endif
             for( uint8_t j=i; j>8; j-- ) {
-                frameBuffer.floor[j] = frameBuffer.floor[j - 1];
+                FLOOR(j) = FLOOR(j - 1);
             }
-            frameBuffer.floor[8] = 0xc003;
+            FLOOR(8) = 0xc003;
             updatePoints();
+            SOUND_EFFECT(SOUND_LINE_CLEAR);
+            cleared++;
             continue;
         }
         i--;
     }
+    VERSUS_LINES_CLEARED(cleared);
+    /* the board is already collapsed, the animation replays it over the last frame */
+    GAME_LINES_CLEARED(clearedRows);
+    PROFILE_END(PROF_DELETE_LEVEL);
 }
 
 uint8_t is_spaceDown() {
     uint8_t status = TRUE;
 
-    if( frameBuffer.blocks[31] != 0 ) status = FALSE;
-
-    for( uint8_t i=30; i>=7; i-- ) {
-        if( (frameBuffer.blocks[i] & frameBuffer.floor[i + 1]) != 0 ) status = FALSE;
+    /* rows below the playfield are solid, which also stops the block at row 31 */
+    for( uint8_t k=0; k<BLOCK_ROWS; k++ ) {
+        if( frameBuffer.block[k] & floorAt(coords.y + k) ) status = FALSE;
     }
     return status;
 }
 
 void moveBlockDown() {
+    PROFILE_BEGIN(PROF_MOVE_BLOCK_DOWN);
     if( is_spaceDown() == TRUE ) {
-        for( uint8_t i=31; i>7; i-- ) {
-            frameBuffer.blocks[i] = frameBuffer.blocks[i - 1];
-        }
+        /* the block window moves with coords, no rows have to be copied */
         coords.y++;
-        updateFramebuffer();
+        FRAME_CHANGED();
     } 
     else {
-        for( uint8_t i=31; i>7; i-- ) {
-            frameBuffer.floor[i] += frameBuffer.blocks[i];
+        for( uint8_t k=0; k<BLOCK_ROWS; k++ ) {
+            if( frameBuffer.block[k] ) FLOOR(coords.y - 1 + k) |= frameBuffer.block[k];
         }
+        SOUND_EFFECT(SOUND_LOCK);
         deleteLevel();
         displayNewBlock();
-        updateFramebuffer();
+        REWIND_PUSH();
+        FRAME_CHANGED();
     }
+    PROFILE_END(PROF_MOVE_BLOCK_DOWN);
 }
 
 uint8_t is_spaceLeft() {
     uint8_t status = TRUE;
-    for( int8_t i=-2; i<=2; ++i ) {
-        if( frameBuffer.blocks[coords.y + i] & frameBuffer.floor[coords.y + i]>>1 ) {
+    for( uint8_t k=0; k<BLOCK_ROWS; k++ ) {
+        if( frameBuffer.block[k] & floorAt(coords.y - 1 + k)>>1 ) {
             status = FALSE;
         }
     }
@@ -127,18 +277,18 @@ uint8_t is_spaceLeft() {
 
 void moveBlockLeft() {
     if ( is_spaceLeft() == TRUE ) {
-        for( int8_t y=-1; y<3; y++ ) {
-            frameBuffer.blocks[coords.y + y] = frameBuffer.blocks[coords.y + y]<<1;
+        for( uint8_t k=0; k<BLOCK_ROWS; k++ ) {
+            frameBuffer.block[k] = frameBuffer.block[k]<<1;
         }
         coords.x++;
-        updateFramebuffer();
+        FRAME_CHANGED();
     }
 }
 
 uint8_t is_spaceRight() {
     uint8_t status = TRUE;
-    for( int8_t i=-2; i<=2; ++i ) {
-        if( frameBuffer.blocks[coords.y + i] & frameBuffer.floor[coords.y + i]<<1 ) {
+    for( uint8_t k=0; k<BLOCK_ROWS; k++ ) {
+        if( frameBuffer.block[k] & floorAt(coords.y - 1 + k)<<1 ) {
             status = FALSE;
         }
     }
@@ -147,57 +297,71 @@ uint8_t is_spaceRight() {
 
 void moveBlockRight() {
     if( is_spaceRight() == TRUE ) {
-        for( int8_t y=-1; y<3; y++ ) {
-            frameBuffer.blocks[coords.y + y] = frameBuffer.blocks[coords.y + y]>>1;
+        for( uint8_t k=0; k<BLOCK_ROWS; k++ ) {
+            frameBuffer.block[k] = frameBuffer.block[k]>>1;
         }
         coords.x--;
-        updateFramebuffer();
+        FRAME_CHANGED();
     }
 }
 
 void updateFramebuffer() {
-    for( uint8_t i=0; i<32; i++ ) {
-        frameBuffer.main[i] = frameBuffer.blocks[i] | frameBuffer.floor[i]; 
+    PROFILE_BEGIN(PROF_UPDATE_FB);
+    for( uint8_t i=0; i<FLOOR_TOP; i++ ) {
+        frameBuffer.main[i] = 0;
     }
-    frameBuffer.main[3] = frameBuffer.nextBlock[0];
-    frameBuffer.main[4] = frameBuffer.nextBlock[1];
-    for( uint8_t i=1; i<6; i++ ) {
-        frameBuffer.main[i] |= frameBuffer.points100[i - 1] | frameBuffer.points010[i - 1] | frameBuffer.points001[i - 1]; 
+    for( uint8_t i=FLOOR_TOP; i<32; i++ ) {
+        uint16_t row = FLOOR(i);
+        uint8_t k = i - coords.y + 1;       /* wraps above the block window */
+        if( k < BLOCK_ROWS ) row |= frameBuffer.block[k];
+        frameBuffer.main[i] = row;          /* one write per row, the ISR never sees a half-drawn row */
     }
+
+    /* overlays are generated here instead of being kept in SRAM */
+    if( frameBuffer.overlay & OVERLAY_PIECES ) {
+        for( uint8_t i=0; i<PREVIEW_COUNT; i++ ) {
+            drawPiece(i, previewQueue[i]);
+        }
+#ifdef HOLD_ENABLE
+        drawPiece(PREVIEW_COUNT, heldBlock);
+#endif
+    }
+    if( frameBuffer.overlay & OVERLAY_SCORE ) {
+        for( uint8_t i=0; i<5; i++ ) {
+            frameBuffer.main[i + 1] |= digitRow(frameBuffer.digits, i);
+        }
+    }
+    DISPLAY_FLUSH();
+    PROFILE_END(PROF_UPDATE_FB);
+}
+
+void framePublish() {
+    if( frameDirty == FALSE || frameHeld == TRUE ) return;
+    frameDirty = FALSE;
+    updateFramebuffer();
 }
 
 void framebufferInit() {
-    for( uint8_t i=0; i<8; ++i ) {
-        frameBuffer.blocks[i] = 0;
-        frameBuffer.floor[i] = 0;
+    FLOOR(7) = 0xffff;
+    for( uint8_t i=8; i<32; ++i ) {
+        FLOOR(i) = 0xc003;
     }
-
-    for( uint8_t i=7; i<32; ++i ) {
-        frameBuffer.blocks[i] = 0;
-        frameBuffer.floor[i] = 0xc003;
+    for( uint8_t k=0; k<BLOCK_ROWS; k++ ) {
+        frameBuffer.block[k] = 0;
     }
-    frameBuffer.floor[7] = 0xffff;
 
     /* display "000" points */
-    frameBuffer.points100[0] = 0xe000;
-    frameBuffer.points100[1] = 0xa000;
-    frameBuffer.points100[2] = 0xa000;
-    frameBuffer.points100[3] = 0xa000;
-    frameBuffer.points100[4] = 0xe000;
-
-    frameBuffer.points010[0] = 0x0e00;
-    frameBuffer.points010[1] = 0x0a00;
-    frameBuffer.points010[2] = 0x0a00;
-    frameBuffer.points010[3] = 0x0a00;
-    frameBuffer.points010[4] = 0x0e00;
-
-    frameBuffer.points001[0] = 0x00e0;
-    frameBuffer.points001[1] = 0x00a0;
-    frameBuffer.points001[2] = 0x00a0;
-    frameBuffer.points001[3] = 0x00a0;
-    frameBuffer.points001[4] = 0x00e0;
-
-    nextBlock = timer_ms%7;
+    frameBuffer.digits[0] = 0;
+    frameBuffer.digits[1] = 0;
+    frameBuffer.digits[2] = 0;
+    frameBuffer.overlay = OVERLAY_SCORE | OVERLAY_PIECES;
+
+    randomState = tickNow() | 1;    /* any non-zero seed */
+    for( uint8_t i=0; i<PREVIEW_COUNT; i++ ) {
+        previewQueue[i] = randomBlock();
+    }
+    heldBlock = NO_BLOCK;
+    holdUsed = FALSE;
 }
 
 void buttonsInit() {
@@ -206,467 +370,147 @@ void buttonsInit() {
 }
 
 void displayPLAY() {
-    for( uint8_t i=0; i<32; ++i ) {
-        frameBuffer.main[i] = 0;
-        frameBuffer.blocks[i] = 0;
-        frameBuffer.floor[i] = 0;
-    }
-    for( uint8_t i=0; i<5; ++i ) {
-        frameBuffer.points100[i] = 0;
-        frameBuffer.points010[i] = 0;
-        frameBuffer.points001[i] = 0;
+    for( uint8_t k=0; k<BLOCK_ROWS; k++ ) {
+        frameBuffer.block[k] = 0;
     }
+    frameBuffer.overlay = 0;
 
-    frameBuffer.floor[14] = 0xe8ea;
-    frameBuffer.floor[15] = 0xa8aa;
-    frameBuffer.floor[16] = 0xe8e4;
-    frameBuffer.floor[17] = 0x88a4;
-    frameBuffer.floor[18] = 0x8ea4;
+    bitmapDraw(BITMAP_PLAY, &FLOOR(FLOOR_TOP), FLOOR_ROWS);
     updateFramebuffer();
 }
 
-void GameOver() {
-    timer_ms = 0;
-    while( timer_ms < 500 )
-        ;
-    for( uint8_t j=0; j<5; j++ ) {
-        for( uint8_t i=0; i<32; ++i ) {
-            frameBuffer.main[i] = 0xffff;
-        }
-        timer_ms = 0;
-        while( timer_ms < 500 )
-            ;
-        for( uint8_t i=0; i<32; ++i ) {
-            frameBuffer.main[i] = 0x0000;
-        }
-        timer_ms = 0;
-        while (timer_ms < 500)
-            ;
-    }
+void displayScore() {
     pointsCounter--;
-    for( uint8_t i=0; i<32; ++i ) {
-        frameBuffer.floor[i] = 0x0000;
-        frameBuffer.blocks[i] = 0x0000;
+    for( uint8_t i=FLOOR_TOP; i<32; ++i ) {
+        FLOOR(i) = 0x0000;
+    }
+    for( uint8_t k=0; k<BLOCK_ROWS; k++ ) {
+        frameBuffer.block[k] = 0x0000;
     }
-    frameBuffer.nextBlock[0] = 0x0000;
-    frameBuffer.nextBlock[1] = 0x0000;
+    frameBuffer.overlay = OVERLAY_SCORE;
     updatePoints();
+    FRAME_PUBLISH();
+}
 
-    /* display points until reset */
-    while(1)
-        ;
+void displayNumber(uint8_t row, uint16_t value) {
+    uint8_t digits[3];
+
+    digits[0] = (value/100) % 10;
+    digits[1] = (value % 100)/10;
+    digits[2] = value % 10;
+    for( uint8_t i=0; i<5; i++ ) {
+        FLOOR(row + i) = digitRow(digits, i);
+    }
+    FRAME_CHANGED();
 }
 
-void rotateBlockRight() { 
-    if( currentBlock != I_BLOCK ) { /* if currentblock != BLOCK_I */
-        int8_t crossArr[5] = { };
-        int8_t diamondArr[4] = { };
-        int8_t c = 0;
-        int8_t d = 0;
-        for( int8_t i=-1; i<2; i++ ) {
-            for( int8_t j=-1; j<2; j++ ) {
-                if( frameBuffer.blocks[coords.y + i] & (1<<(coords.x + j)) ) {
-                    if( (i + j) % 2 ) {
-                        diamondArr[c] = 1;
-                        c++;
-                    } 
-                    else {
-                        crossArr[d] = 1;
-                        d++;
-                    }
-                } else {
-                    if( (i + j) % 2 ) {
-                        diamondArr[c] = 0;
-                        c++;
-                    } 
-                    else {
-                        crossArr[d] = 0;
-                        d++;
-                    }
-                }
-            }
-        }
+void newGame() {
+    pointsCounter = 0;
+    lvl = 0;
+    gameOver = FALSE;
+    REWIND_RESET();
+    framebufferInit();
+    displayNewBlock();
+    REWIND_PUSH();
+}
 
-        int8_t newTable[9] = { };
-
-        newTable[0] = crossArr[1];
-        newTable[1] = diamondArr[2];
-        newTable[2] = crossArr[4];
-        newTable[3] = diamondArr[0];
-        newTable[4] = crossArr[2];
-        newTable[5] = diamondArr[3];
-        newTable[6] = crossArr[0];
-        newTable[7] = diamondArr[1];
-        newTable[8] = crossArr[3];
-
-        /* validation */
-        c = 1;
-        int8_t g;
-        for( int8_t i=-1; i<2; i++ ) {
-            g = frameBuffer.floor[coords.y + i];
-            for( int16_t j=-1; j<2; j++ ) {
-                if( newTable[i*3 + j + 4] ) {
-                    if( g & (1<<(coords.x + j)) ) c = 0;  // validation == failed
-                }
-            }
-        }
+void rotateBlockRight() {
+    PROFILE_BEGIN(PROF_ROTATE_BLOCK);
+    uint8_t next = (blockRotation + 1) & 3;
+    uint16_t shape = pgm_read_word(&blockRotations[currentBlock][next]);
+    uint8_t shift = coords.x - 2;
+    uint8_t fits = TRUE;
 
-        /* if validation successful */
-        if( c != 0 ) {
-            for( int8_t i=-1; i<2; i++ ) {
-                g = 0;
-                for( int8_t j=-1; j<2; j++ ) {
-                    if( newTable[i*3 + j + 4] ) g = g ^ (1<<(coords.x + j) );
-                }
-                frameBuffer.blocks[coords.y + i] = g;
-            }
-            updateFramebuffer();
-        }
-    } 
-    else { /* case for BLOCK_I */
-        /* check position */
-        if( frameBuffer.blocks[coords.y - 1] == (1<<coords.x) ) { /* vertical */
-            /* check if validation vertical -> horizontal == successful */
-            if( !((15<<(coords.x - 2)) & frameBuffer.floor[coords.y]) ) {
-                frameBuffer.blocks[coords.y - 1] = 0;
-                frameBuffer.blocks[coords.y] = 15 << (coords.x - 2);
-                frameBuffer.blocks[coords.y + 1] = 0;
-                frameBuffer.blocks[coords.y + 2] = 0;
-                updateFramebuffer();
-            }
-        } 
-        else {  /* horizontal */
-            int8_t c = 1;
-            /* check if validation horizontal -> vertical == successful */
-            for( int8_t i=-1; i<3; i++ ) {
-                if( frameBuffer.floor[coords.y + i] & (1<<coords.x) ) c = 0;
-            }
-            if( c != 0 ) {
-                for (int16_t i=-1; i<3; i++) {
-                    frameBuffer.blocks[coords.y + i] = 1<<coords.x;
-                }
-                updateFramebuffer();
-            }
+    /* validation; rows outside of the playfield are solid */
+    for( int8_t dy=-1; dy<3; dy++ ) {
+        if( (BOX_ROW(shape, dy) << shift) & floorAt(coords.y + dy) ) fits = FALSE;
+    }
+
+    /* if validation successful */
+    if( fits == TRUE ) {
+        for( int8_t dy=-1; dy<3; dy++ ) {
+            frameBuffer.block[dy + 1] = BOX_ROW(shape, dy) << shift;
         }
+        blockRotation = next;
+        FRAME_CHANGED();
     }
+    PROFILE_END(PROF_ROTATE_BLOCK);
 }
 
-void displayNewBlock() {
+void spawnBlock() {
     /*delete previous block from block frame buffer*/
-    for( int8_t i=-2; i<=2; ++i ) {
-        frameBuffer.blocks[coords.y + i] = 0x0000;
+    for( uint8_t k=0; k<BLOCK_ROWS; k++ ) {
+        frameBuffer.block[k] = 0x0000;
     }
 
     /* assign coordinates of new core field of new block */
     coords.x = 8;
     coords.y = 8;
-    currentBlock = nextBlock;
-    nextBlock = timer_ms%7;
-
-    switch (currentBlock) {
-        case I_BLOCK:
-            frameBuffer.blocks[8] = 0x03c0;
-            frameBuffer.blocks[9] = 0x0000;
-            break;
-        case J_BLOCK:
-            frameBuffer.blocks[8] = 0x0380;
-            frameBuffer.blocks[9] = 0x0080;
-            break;
-        case L_BLOCK:
-            frameBuffer.blocks[8] = 0x0380;
-            frameBuffer.blocks[9] = 0x0200;
-            break;
-        case O_BLOCK:
-            frameBuffer.blocks[8] = 0x0180;
-            frameBuffer.blocks[9] = 0x0180;
-            break;
-        case S_BLOCK:
-            frameBuffer.blocks[8] = 0x0180;
-            frameBuffer.blocks[9] = 0x0300;
-            break;
-        case T_BLOCK:
-            frameBuffer.blocks[8] = 0x0380;
-            frameBuffer.blocks[9] = 0x0100;
-            break;
-        default:
-            frameBuffer.blocks[8] = 0x0300;
-            frameBuffer.blocks[9] = 0x0180;
-            break;
-    }
 
-    displayNextBlock();
-    updateFramebuffer();
+    /* spawn shapes occupy rows 8 and 9 only */
+    uint16_t shape = pgm_read_word(&blockRotations[currentBlock][0]);
+    frameBuffer.block[1] = BOX_ROW(shape, 0) << (coords.x - 2);
+    frameBuffer.block[2] = BOX_ROW(shape, 1) << (coords.x - 2);
+    blockRotation = 0;
+
+    FRAME_CHANGED();
 
     /* check if a new block has space to be spawned */
-    if( frameBuffer.blocks[9] & frameBuffer.floor[9] ) GameOver();
-    if( frameBuffer.blocks[8] & frameBuffer.floor[8] ) GameOver();
+    if( (frameBuffer.block[2] & FLOOR(9)) || (frameBuffer.block[1] & FLOOR(8)) ) {
+        GameOver();
+        return;
+    }
+
+    SAVE_REQUEST();
 }
 
-void displayNextBlock() {
-    switch (nextBlock) {
-        case I_BLOCK:
-            frameBuffer.nextBlock[0] = 0x000f;
-            frameBuffer.nextBlock[1] = 0x0000;
-            break;
-        case J_BLOCK:
-            frameBuffer.nextBlock[0] = 0x000e;
-            frameBuffer.nextBlock[1] = 0x0002;
-            break;
-        case L_BLOCK:
-            frameBuffer.nextBlock[0] = 0x000e;
-            frameBuffer.nextBlock[1] = 0x0008;
-            break;
-        case O_BLOCK:
-            frameBuffer.nextBlock[0] = 0x0006;
-            frameBuffer.nextBlock[1] = 0x0006;
-            break;
-        case S_BLOCK:
-            frameBuffer.nextBlock[0] = 0x0006;
-            frameBuffer.nextBlock[1] = 0x000c;
-            break;
-        case T_BLOCK:
-            frameBuffer.nextBlock[0] = 0x000e;
-            frameBuffer.nextBlock[1] = 0x0004;
-            break;
-        default:
-            frameBuffer.nextBlock[0] = 0x000c;
-            frameBuffer.nextBlock[1] = 0x0006;
-            break;
+void displayNewBlock() {
+    /* take the first block of the queue and append a random one */
+    currentBlock = previewQueue[0];
+    for( uint8_t i=1; i<PREVIEW_COUNT; i++ ) {
+        previewQueue[i - 1] = previewQueue[i];
     }
+    previewQueue[PREVIEW_COUNT - 1] = randomBlock();
+    holdUsed = FALSE;
+
+    addGarbage(VERSUS_TAKE_GARBAGE());
+    if( gameOver == TRUE ) return;
+    spawnBlock();
 }
 
+void holdBlock() {
+#ifdef HOLD_ENABLE
+    BlockType held = heldBlock;
+
+    if( holdUsed == TRUE ) return;
+    heldBlock = currentBlock;
+    if( held == NO_BLOCK ) {
+        displayNewBlock();
+    }
+    else {
+        currentBlock = held;
+        spawnBlock();
+    }
+    holdUsed = TRUE;
+    if( gameOver == TRUE ) return;
+    /* the snapshot taken by spawnBlock() still allowed a hold */
+    SAVE_REQUEST();
+#endif
+}
+
+
 void updatePoints() {
+    PROFILE_BEGIN(PROF_UPDATE_POINTS);
     pointsCounter++;
 
     /* use lvl variable to scale the speed of blocks */
     if( pointsCounter < 100 ) lvl = pointsCounter * 3;
 
-    /* calculate very digit of points value */
-    uint8_t hundreds = pointsCounter/100;
-    uint8_t tens = pointsCounter % 100;
-    tens = tens/10;
-    uint8_t unity = pointsCounter % 10;
-
-    /* display hundreds digit */
-    switch (hundreds) {
-        case 0:
-            frameBuffer.points100[0] = 0xe000;
-            frameBuffer.points100[1] = 0xa000;
-            frameBuffer.points100[2] = 0xa000;
-            frameBuffer.points100[3] = 0xa000;
-            frameBuffer.points100[4] = 0xe000;
-            break;
-    	case 1:
-            frameBuffer.points100[0] = 0x4000;
-            frameBuffer.points100[1] = 0xc000;
-            frameBuffer.points100[2] = 0x4000;
-            frameBuffer.points100[3] = 0x4000;
-            frameBuffer.points100[4] = 0xe000;
-           break;
-        case 2:
-            frameBuffer.points100[0] = 0xe000;
-            frameBuffer.points100[1] = 0x2000;
-            frameBuffer.points100[2] = 0xe000;
-            frameBuffer.points100[3] = 0x8000;
-            frameBuffer.points100[4] = 0xe000;
-            break;
-        case 3:
-            frameBuffer.points100[0] = 0xe000;
-            frameBuffer.points100[1] = 0x2000;
-            frameBuffer.points100[2] = 0xe000;
-            frameBuffer.points100[3] = 0x2000;
-            frameBuffer.points100[4] = 0xe000;
-            break;
-        case 4:
-            frameBuffer.points100[0] = 0xa000;
-            frameBuffer.points100[1] = 0xa000;
-            frameBuffer.points100[2] = 0xe000;
-            frameBuffer.points100[3] = 0x2000;
-            frameBuffer.points100[4] = 0x2000;
-            break;
-        case 5:
-            frameBuffer.points100[0] = 0xe000;
-            frameBuffer.points100[1] = 0x8000;
-            frameBuffer.points100[2] = 0xe000;
-            frameBuffer.points100[3] = 0x2000;
-            frameBuffer.points100[4] = 0xe000;
-            break;
-        case 6:
-            frameBuffer.points100[0] = 0xe000;
-            frameBuffer.points100[1] = 0x8000;
-            frameBuffer.points100[2] = 0xe000;
-            frameBuffer.points100[3] = 0xa000;
-            frameBuffer.points100[4] = 0xe000;
-            break;
-        case 7:
-            frameBuffer.points100[0] = 0xe000;
-            frameBuffer.points100[1] = 0xa000;
-            frameBuffer.points100[2] = 0x2000;
-            frameBuffer.points100[3] = 0x2000;
-            frameBuffer.points100[4] = 0x2000;
-            break;
-        case 8:
-            frameBuffer.points100[0] = 0xe000;
-            frameBuffer.points100[1] = 0xa000;
-            frameBuffer.points100[2] = 0xe000;
-            frameBuffer.points100[3] = 0xa000;
-            frameBuffer.points100[4] = 0xe000;
-            break;
-        case 9:
-            frameBuffer.points100[0] = 0xe000;
-            frameBuffer.points100[1] = 0xa000;
-            frameBuffer.points100[2] = 0xe000;
-            frameBuffer.points100[3] = 0x2000;
-            frameBuffer.points100[4] = 0xe000;
-            break;
-    }
-
-    /* display tens digit */
-    switch (tens) {
-        case 0:
-            frameBuffer.points010[0] = 0x0e00;
-            frameBuffer.points010[1] = 0x0a00;
-            frameBuffer.points010[2] = 0x0a00;
-            frameBuffer.points010[3] = 0x0a00;
-            frameBuffer.points010[4] = 0x0e00;
-            break;
-        case 1:
-            frameBuffer.points010[0] = 0x0400;
-            frameBuffer.points010[1] = 0x0c00;
-            frameBuffer.points010[2] = 0x0400;
-            frameBuffer.points010[3] = 0x0400;
-            frameBuffer.points010[4] = 0x0e00;
-    	    break;
-        case 2:
-            frameBuffer.points010[0] = 0x0e00;
-            frameBuffer.points010[1] = 0x0200;
-            frameBuffer.points010[2] = 0x0e00;
-            frameBuffer.points010[3] = 0x0800;
-            frameBuffer.points010[4] = 0x0e00;
-            break;
-        case 3:
-            frameBuffer.points010[0] = 0x0e00;
-            frameBuffer.points010[1] = 0x0200;
-            frameBuffer.points010[2] = 0x0e00;
-            frameBuffer.points010[3] = 0x0200;
-            frameBuffer.points010[4] = 0x0e00;
-            break;
-        case 4:
-            frameBuffer.points010[0] = 0x0a00;
-            frameBuffer.points010[1] = 0x0a00;
-            frameBuffer.points010[2] = 0x0e00;
-            frameBuffer.points010[3] = 0x0200;
-            frameBuffer.points010[4] = 0x0200;
-            break;
-        case 5:
-            frameBuffer.points010[0] = 0x0e00;
-            frameBuffer.points010[1] = 0x0800;
-            frameBuffer.points010[2] = 0x0e00;
-            frameBuffer.points010[3] = 0x0200;
-            frameBuffer.points010[4] = 0x0e00;
-            break;
-        case 6:
-            frameBuffer.points010[0] = 0x0e00;
-            frameBuffer.points010[1] = 0x0800;
-            frameBuffer.points010[2] = 0x0e00;
-            frameBuffer.points010[3] = 0x0a00;
-            frameBuffer.points010[4] = 0x0e00;
-            break;
-        case 7:
-            frameBuffer.points010[0] = 0x0e00;
-            frameBuffer.points010[1] = 0x0a00;
-            frameBuffer.points010[2] = 0x0200;
-            frameBuffer.points010[3] = 0x0200;
-            frameBuffer.points010[4] = 0x0200;
-            break;
-        case 8:
-            frameBuffer.points010[0] = 0x0e00;
-            frameBuffer.points010[1] = 0x0a00;
-            frameBuffer.points010[2] = 0x0e00;
-            frameBuffer.points010[3] = 0x0a00;
-            frameBuffer.points010[4] = 0x0e00;
-            break;
-        case 9:
-            frameBuffer.points010[0] = 0x0e00;
-            frameBuffer.points010[1] = 0x0a00;
-            frameBuffer.points010[2] = 0x0e00;
-            frameBuffer.points010[3] = 0x0200;
-            frameBuffer.points010[4] = 0x0e00;
-            break;
-    }
+    /* calculate very digit of points value, glyphs are drawn by updateFramebuffer */
+    frameBuffer.digits[0] = (pointsCounter/100) % 10;
+    frameBuffer.digits[1] = (pointsCounter % 100)/10;
+    frameBuffer.digits[2] = pointsCounter % 10;
 
-    /* display unity digit */
-    switch (unity) {
-        case 0:
-            frameBuffer.points001[0] = 0x00e0;
-            frameBuffer.points001[1] = 0x00a0;
-            frameBuffer.points001[2] = 0x00a0;
-            frameBuffer.points001[3] = 0x00a0;
-            frameBuffer.points001[4] = 0x00e0;
-            break;
-        case 1:
-            frameBuffer.points001[0] = 0x0040;
-            frameBuffer.points001[1] = 0x00c0;
-            frameBuffer.points001[2] = 0x0040;
-            frameBuffer.points001[3] = 0x0040;
-            frameBuffer.points001[4] = 0x00e0;
-            break;
-        case 2:
-            frameBuffer.points001[0] = 0x00e0;
-            frameBuffer.points001[1] = 0x0020;
-            frameBuffer.points001[2] = 0x00e0;
-            frameBuffer.points001[3] = 0x0080;
-            frameBuffer.points001[4] = 0x00e0;
-            break;
-        case 3:
-            frameBuffer.points001[0] = 0x00e0;
-            frameBuffer.points001[1] = 0x0020;
-            frameBuffer.points001[2] = 0x00e0;
-            frameBuffer.points001[3] = 0x0020;
-            frameBuffer.points001[4] = 0x00e0;
-            break;
-        case 4:
-            frameBuffer.points001[0] = 0x00a0;
-            frameBuffer.points001[1] = 0x00a0;
-            frameBuffer.points001[2] = 0x00e0;
-            frameBuffer.points001[3] = 0x0020;
-            frameBuffer.points001[4] = 0x0020;
-            break;
-        case 5:
-            frameBuffer.points001[0] = 0x00e0;
-            frameBuffer.points001[1] = 0x0080;
-            frameBuffer.points001[2] = 0x00e0;
-            frameBuffer.points001[3] = 0x0020;
-            frameBuffer.points001[4] = 0x00e0;
-            break;
-        case 6:
-            frameBuffer.points001[0] = 0x00e0;
-            frameBuffer.points001[1] = 0x0080;
-            frameBuffer.points001[2] = 0x00e0;
-            frameBuffer.points001[3] = 0x00a0;
-            frameBuffer.points001[4] = 0x00e0;
-            break;
-        case 7:
-            frameBuffer.points001[0] = 0x00e0;
-            frameBuffer.points001[1] = 0x00a0;
-            frameBuffer.points001[2] = 0x0020;
-            frameBuffer.points001[3] = 0x0020;
-            frameBuffer.points001[4] = 0x0020;
-            break;
-        case 8:
-            frameBuffer.points001[0] = 0x00e0;
-            frameBuffer.points001[1] = 0x00a0;
-            frameBuffer.points001[2] = 0x00e0;
-            frameBuffer.points001[3] = 0x00a0;
-            frameBuffer.points001[4] = 0x00e0;
-            break;
-        case 9:
-            frameBuffer.points001[0] = 0x00e0;
-            frameBuffer.points001[1] = 0x00a0;
-            frameBuffer.points001[2] = 0x00e0;
-            frameBuffer.points001[3] = 0x0020;
-            frameBuffer.points001[4] = 0x00e0;
-            break;
-    }
-    updateFramebuffer();
-}
\ No newline at end of file
+    FRAME_CHANGED();
+    PROFILE_END(PROF_UPDATE_POINTS);
+}
@@ -8,6 +8,8 @@
 #ifndef TETRIS_H_
 #define TETRIS_H_
 
+#include "Config.h"
+
 /*************************************************************************\
                                    MACROS
 \*************************************************************************/
@@ -23,6 +25,12 @@
 #define PC1_PUSHED !(PINC & (1<<PC1))    // right
 #define PC2_PUSHED !(PINC & (1<<PC2))    // down
 #define PC3_PUSHED !(PINC & (1<<PC3))    // left
+/*
+ * @brief Game functions only report a changed frame; it is composed once by
+ *        the render task (or at the end of the logic tick)
+ */
+#define FRAME_CHANGED()  (frameDirty = TRUE)
+#define FRAME_PUBLISH()  framePublish()
 
 /*************************************************************************\
                                 DEFINITIONS
@@ -36,6 +44,15 @@
     #define FALSE   (0)
 #endif
 
+#define FLOOR_TOP           7                                   /* first playfield row (top line) */
+#define FLOOR_ROWS          (32 - FLOOR_TOP)                    /* rows kept in the floor buffer */
+#define BLOCK_ROWS          4                                   /* falling block window, rows y-1..y+2 */
+#define FLOOR(row)          frameBuffer.floor[(row) - FLOOR_TOP]
+#define DISPLAY_CHAIN_BYTES (2*DISPLAY_PANELS + 4)              /* SPI bytes per row */
+#define DISPLAY_ROW_CYCLES  (DISPLAY_CHAIN_BYTES * 136UL)       /* fck/16: 128 per byte + loop */
+#define DEBOUNCE_TICKS      301                                 /* time between button actions */
+#define GRAVITY_TICKS(lvl)  ((((uint16_t)500 - (lvl))<<1) + 1)  /* time between falls */
+
 /*************************************************************************\
                               ENUMS AND STRUCTS
 \*************************************************************************/
@@ -44,15 +61,17 @@
  * @brief Frame buffers data
  */
 typedef struct {
-    uint16_t main[32];
-    uint16_t blocks[32];
-    uint16_t floor[32];
-    uint16_t nextBlock[2];
-
-    uint16_t points100[5];
-    uint16_t points010[5];
-    uint16_t points001[5];
+    uint16_t main[32];              /* composed rows, read by the refresh ISR */
+    uint16_t floor[FLOOR_ROWS];     /* settled blocks, rows FLOOR_TOP..31 */
+    uint16_t block[BLOCK_ROWS];     /* falling block, rows coords.y-1..coords.y+2 */
+    uint8_t digits[3];              /* score digits, hundreds first */
+    uint8_t overlay;                /* OVERLAY_* parts drawn above the playfield */
 } FrameBuffer;
+/*
+ * @brief Parts of the overlay rows composed by updateFramebuffer()
+ */
+#define OVERLAY_SCORE       0x01
+#define OVERLAY_PIECES      0x02
 /*
  * @brief Coordinates of block's core pixel
  */
@@ -70,21 +89,32 @@ typedef enum {
     O_BLOCK = (uint8_t)3,
     S_BLOCK = (uint8_t)4,
     T_BLOCK = (uint8_t)5,
-    Z_BLOCK = (uint8_t)6
+    Z_BLOCK = (uint8_t)6,
+    NO_BLOCK = (uint8_t)7          /* empty hold slot */
 } BlockType;
 
 /*************************************************************************\
                             VARIABLE DECLARATIONS
 \*************************************************************************/
 
-uint16_t pointsCounter;         /* counter of displayed points */
-volatile uint16_t timer_ms;     /* timer variable */
-volatile uint8_t iteratorSPI;   /* iterator used for SPI communication */
-volatile uint16_t debounce;     /* used to get the button debounce effect */
-uint16_t lvl;                   /* level counter; it's used to calculate the speed 
-                                   of falling of the block */
-FrameBuffer frameBuffer;        /* frame buffer struct */
-Coordinates coords;             /* core pixel coordinates struct */
+extern uint16_t pointsCounter;         /* counter of displayed points */
+extern volatile uint8_t iteratorSPI;   /* iterator used for SPI communication */
+extern uint16_t lvl;                   /* level counter; it's used to calculate the speed 
+                                          of falling of the block */
+extern FrameBuffer frameBuffer;        /* frame buffer struct */
+extern Coordinates coords;             /* core pixel coordinates struct */
+extern BlockType currentBlock;         /* falling block */
+extern uint8_t blockRotation;          /* rotation state of the falling block, 0..3 */
+extern BlockType previewQueue[PREVIEW_COUNT];  /* upcoming blocks, [0] is next */
+extern BlockType heldBlock;            /* block in the hold slot or NO_BLOCK */
+extern uint8_t holdUsed;               /* hold already used by the falling block */
+extern uint16_t randomState;           /* state of the block generator */
+#if DISPLAY_PANELS > 1
+extern uint16_t panelMain[DISPLAY_PANELS - 1][32];  /* rows of panels 1..N-1, 1 = lit */
+#endif
+extern uint8_t frameDirty;             /* game state changed since the last composite */
+extern uint8_t frameHeld;              /* an animation owns frameBuffer.main */
+extern uint8_t gameOver;               /* set on game over entry, the board is frozen */
 
 /*************************************************************************\
                                  FUNCTIONS
@@ -104,6 +134,15 @@ void SPI_MasterTransmit_16bit(uint16_t data_bytes);
  * @param four data bytes to send
  */
 void SPI_MasterTransmit_32bit(uint32_t data_bytes);
+/*
+ * @brief transmit the column words of every panel and the one-hot row, then latch
+ * @param row number
+ */
+void SPI_MasterTransmitRow(uint8_t row);
+/*
+ * @brief transmit all columns and rows off, then latch
+ */
+void SPI_MasterTransmitBlank();
 /*
  * @brief initialize TiM0 timer
  */
@@ -143,6 +182,11 @@ void moveBlockRight();
  * @brief sum all framebuffers into main one
  */
 void updateFramebuffer();
+/*
+ * @brief compose the frame if the game changed it since the last call and
+ *        no animation holds the display
+ */
+void framePublish();
 /*
  * @brief initialize frame buffer
  */
@@ -156,21 +200,38 @@ void buttonsInit();
  */
 void displayPLAY();
 /*
- * @brief end the game, display ending sequence
+ * @brief report a top out to the game state machine (Game.c)
  */
 void GameOver();
+/*
+ * @brief clear the playfield and show the final score
+ */
+void displayScore();
+/*
+ * @brief draw a three digit number over five playfield rows
+ * @param first row and value (0..999)
+ */
+void displayNumber(uint8_t row, uint16_t value);
+/*
+ * @brief reset score and board for a new game, the hardware is left as it is
+ */
+void newGame();
 /*
  * @brief rotate block clockwise
  */ 
 void rotateBlockRight();
-/*
- * @brief display next block
- */
-void displayNextBlock();
 /*
  * @brief choose and display new block
  */
 void displayNewBlock();
+/*
+ * @brief put current block at the spawn position
+ */
+void spawnBlock();
+/*
+ * @brief swap current block with the held one (once per block)
+ */
+void holdBlock();
 /*
  * @brief update points status
  */
@@ -0,0 +1,65 @@
+/*
+ * @file Tick.c
+ * @author: JZimnol
+ * @brief File containing definitions for timebase and software timers
+ */ 
+
+#include <avr/io.h>
+#include <util/atomic.h>
+#include "Tetris.h"
+#include "Tick.h"
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+volatile uint32_t tickCount = 0;
+static SoftTimer timers[TIMER_COUNT];   /* used from main context only */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+uint32_t tickNow() {
+    uint32_t now;
+    /* four byte read can be torn by the refresh ISR */
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        now = tickCount;
+    }
+    return now;
+}
+
+void tickTimerStart(uint8_t id, uint32_t ticks) {
+    timers[id].deadline = tickNow() + ticks;
+    timers[id].period = 0;
+    timers[id].running = TRUE;
+}
+
+void tickTimerStartPeriodic(uint8_t id, uint32_t period) {
+    tickTimerStart(id, period);
+    timers[id].period = period;
+}
+
+uint8_t tickTimerExpired(uint8_t id) {
+    SoftTimer *timer = &timers[id];
+    uint32_t now;
+
+    if( timer->running == FALSE ) return FALSE;
+    now = tickNow();
+    /* signed difference keeps working when the counter wraps */
+    if( (int32_t)(now - timer->deadline) < 0 ) return FALSE;
+
+    if( timer->period != 0 ) {
+        timer->deadline += timer->period;
+        if( (int32_t)(now - timer->deadline) >= 0 ) timer->deadline = now + timer->period;
+    }
+    else {
+        timer->running = FALSE;
+    }
+    return TRUE;
+}
+
+uint8_t tickTimerIdle(uint8_t id) {
+    tickTimerExpired(id);
+    return timers[id].running == FALSE;
+}
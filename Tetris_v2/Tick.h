@@ -0,0 +1,97 @@
+/*
+ * @file Tick.h
+ * @author: JZimnol
+ * @brief File containing monotonic timebase and software timers
+ */ 
+
+
+#ifndef TICK_H_
+#define TICK_H_
+
+#include "Config.h"
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+/*
+ * @brief One tick is one row slot of the refresh ISR
+ */
+#define TICK_PERIOD_US      512
+#define TICKS_FROM_MS(ms)   ((uint32_t)(ms) * 1000 / TICK_PERIOD_US)
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Software timers; every subsystem owns its own entry
+ */
+typedef enum {
+    TIMER_GRAVITY   = (uint8_t)0,    /* automatic fall of the block */
+    TIMER_DEBOUNCE  = (uint8_t)1,    /* minimal time between button actions */
+    TIMER_ANIMATION = (uint8_t)2,    /* splash and game over sequences */
+    TIMER_PROFILE   = (uint8_t)3,    /* profiler stream period */
+    TIMER_MEMORY    = (uint8_t)4,    /* memory report period */
+    TIMER_LINK_RETRY = (uint8_t)5,   /* versus message waiting for an ack */
+    TIMER_LINK_PING = (uint8_t)6,    /* versus keepalive period */
+    TIMER_SCHED     = (uint8_t)7,    /* task statistics report period */
+    TIMER_SOUND     = (uint8_t)8,    /* end of the sounding note */
+    TIMER_WATCHDOG  = (uint8_t)9,    /* overrun count written to EEPROM */
+    TIMER_COUNT     = (uint8_t)10
+} TimerId;
+/*
+ * @brief State of a software timer
+ */
+typedef struct {
+    uint32_t deadline;
+    uint32_t period;                 /* 0 for one-shot timers */
+    uint8_t running;
+} SoftTimer;
+
+/*************************************************************************\
+                            VARIABLE DECLARATIONS
+\*************************************************************************/
+
+extern volatile uint32_t tickCount;  /* written only by the refresh ISR */
+
+/*************************************************************************\
+                                 MACROS
+\*************************************************************************/
+/*
+ * @brief advance the timebase; use only in the refresh ISR
+ */
+#define TICK_ADVANCE(n)     (tickCount += (n))
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief get a consistent copy of the tick counter
+ * @return ticks since power up
+ */
+uint32_t tickNow();
+/*
+ * @brief start (or restart) a one-shot timer
+ * @param timer id and ticks until it expires
+ */
+void tickTimerStart(uint8_t id, uint32_t ticks);
+/*
+ * @brief start (or restart) a periodic timer
+ * @param timer id and period in ticks
+ */
+void tickTimerStartPeriodic(uint8_t id, uint32_t period);
+/*
+ * @brief check if a timer expired; a one-shot timer stops, a periodic timer
+ *        is rearmed one period later (missed periods are not accumulated)
+ * @param timer id
+ * @return true once per expiry, false otherwise or when stopped
+ */
+uint8_t tickTimerExpired(uint8_t id);
+/*
+ * @brief check if a one-shot timer is idle (never started or expired)
+ * @param timer id
+ * @return true or false
+ */
+uint8_t tickTimerIdle(uint8_t id);
+
+#endif /* TICK_H_ */
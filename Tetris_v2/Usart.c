@@ -0,0 +1,90 @@
+/*
+ * @file Usart.c
+ * @author: JZimnol
+ * @brief File containing definitions for interrupt driven USART0 driver
+ */ 
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "Tetris.h"
+#include "Usart.h"
+
+#ifdef USART_ENABLE
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static uint8_t txBuffer[USART_TX_BUFFER_SIZE];
+static volatile uint8_t txHead = 0;     /* written by producer */
+static volatile uint8_t txTail = 0;     /* written by UDRE interrupt */
+#ifdef USART_RX_ENABLE
+static uint8_t rxBuffer[USART_RX_BUFFER_SIZE];
+static volatile uint8_t rxHead = 0;     /* written by RX interrupt */
+static volatile uint8_t rxTail = 0;     /* written by consumer */
+#endif
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+void USART_Init() {
+    UBRR0  = (F_CPU / (8UL * USART_BAUD)) - 1;
+    UCSR0A = (1<<U2X0);
+    UCSR0C = (1<<UCSZ01) | (1<<UCSZ00);   /* 8 data bits, no parity, 1 stop bit */
+#ifdef USART_RX_ENABLE
+    UCSR0B = (1<<TXEN0) | (1<<RXEN0) | (1<<RXCIE0);
+#else
+    UCSR0B = (1<<TXEN0);
+#endif
+}
+
+uint8_t USART_TxFree() {
+    return (USART_TX_BUFFER_SIZE - 1) - ((txHead - txTail) & (USART_TX_BUFFER_SIZE - 1));
+}
+
+uint8_t USART_Transmit(uint8_t data) {
+    uint8_t next = (txHead + 1) & (USART_TX_BUFFER_SIZE - 1);
+
+    if( next == txTail ) return FALSE;
+    txBuffer[txHead] = data;
+    txHead = next;
+    UCSR0B |= (1<<UDRIE0);    /* (re)start draining the buffer */
+    return TRUE;
+}
+
+#ifdef USART_RX_ENABLE
+uint8_t USART_Receive(uint8_t *data) {
+    uint8_t tail = rxTail;
+
+    if( tail == rxHead ) return FALSE;
+    *data = rxBuffer[tail];
+    rxTail = (tail + 1) & (USART_RX_BUFFER_SIZE - 1);
+    return TRUE;
+}
+
+/* byte received - only store it, frames are parsed in the main loop */
+ISR(USART_RX_vect) {
+    uint8_t data = UDR0;
+    uint8_t next = (rxHead + 1) & (USART_RX_BUFFER_SIZE - 1);
+
+    /* on overflow drop the byte, the frame CRC rejects the damaged frame */
+    if( next == rxTail ) return;
+    rxBuffer[rxHead] = data;
+    rxHead = next;
+}
+#endif
+
+/* data register empty - send next queued byte */
+ISR(USART_UDRE_vect) {
+    uint8_t tail = txTail;
+
+    if( tail == txHead ) {
+        UCSR0B &= ~(1<<UDRIE0);
+        return;
+    }
+    UDR0 = txBuffer[tail];
+    txTail = (tail + 1) & (USART_TX_BUFFER_SIZE - 1);
+}
+
+#endif /* USART_ENABLE */
@@ -0,0 +1,63 @@
+/*
+ * @file Usart.h
+ * @author: JZimnol
+ * @brief File containing interrupt driven USART0 driver
+ */ 
+
+
+#ifndef USART_H_
+#define USART_H_
+
+#include "Config.h"
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+
+/*
+ * @brief The receiver holds 3 bytes (UDR0 FIFO + shift register) while the
+ *        refresh ISR runs (~100 us), so the link runs at 62.5 kbaud
+ *        (160 us per byte); transmit-only telemetry can use 500 kbaud.
+ *        Remote input uses 38400, a rate every host serial port has.
+ */
+#ifndef USART_BAUD
+    #ifdef VERSUS_ENABLE
+        #define USART_BAUD      62500UL   /* exact with U2X0 at 8 MHz */
+    #elif defined(REMOTE_ENABLE)
+        #define USART_BAUD      38400UL   /* 0.2 % error with U2X0 at 8 MHz */
+    #else
+        #define USART_BAUD      500000UL  /* exact with U2X0 at 8 MHz */
+    #endif
+#endif
+
+#define USART_TX_BUFFER_SIZE    64        /* must be a power of two */
+#define USART_RX_BUFFER_SIZE    32        /* must be a power of two */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief initialize USART0 transmitter, with VERSUS_ENABLE or REMOTE_ENABLE
+ *        also the receiver (8N1, double speed)
+ */
+void USART_Init();
+/*
+ * @brief get number of free bytes in the transmit buffer
+ * @return free bytes
+ */
+uint8_t USART_TxFree();
+/*
+ * @brief queue one byte for transmission; never waits for the line
+ * @param byte to send
+ * @return true if queued, false if the buffer is full
+ */
+uint8_t USART_Transmit(uint8_t data);
+/*
+ * @brief take one received byte; never waits for the line
+ * @param destination of the byte
+ * @return true if a byte was taken, false if nothing has been received
+ */
+uint8_t USART_Receive(uint8_t *data);
+
+#endif /* USART_H_ */
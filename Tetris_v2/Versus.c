@@ -0,0 +1,177 @@
+/*
+ * @file Versus.c
+ * @author: JZimnol
+ * @brief File containing definitions for the two-board versus link
+ */ 
+
+#include <avr/io.h>
+#include <util/crc16.h>
+#include "Tetris.h"
+#include "Versus.h"
+
+#ifdef VERSUS_ENABLE
+
+#include "Usart.h"
+#include "Tick.h"
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static uint8_t queueType[VERSUS_QUEUE_SIZE];
+static uint8_t queueSeq[VERSUS_QUEUE_SIZE];
+static uint8_t queueArg[VERSUS_QUEUE_SIZE];
+static uint8_t queueHead = 0;           /* oldest message, the one in flight */
+static uint8_t queueCount = 0;
+static uint8_t inFlight = FALSE;        /* head sent, waiting for its ack */
+static uint8_t txSeq = 0;               /* sequence number of next message */
+static uint8_t rxExpected = 0;          /* sequence number expected from the peer */
+static uint8_t rxSynced = FALSE;        /* rxExpected taken from the peer's frames */
+
+static uint8_t frame[VERSUS_FRAME_BYTES - 1];   /* received frame without sync */
+static uint8_t frameIndex = 0;          /* 0 = waiting for sync */
+
+static uint8_t garbagePending = 0;
+static uint8_t peerLost = FALSE;
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/* frames are never split in the transmit buffer */
+static uint8_t sendFrame(uint8_t type, uint8_t seq, uint8_t arg) {
+    uint8_t crc = 0;
+
+    if( USART_TxFree() < VERSUS_FRAME_BYTES ) return FALSE;
+    crc = _crc8_ccitt_update(crc, type);
+    crc = _crc8_ccitt_update(crc, seq);
+    crc = _crc8_ccitt_update(crc, arg);
+    USART_Transmit(VERSUS_SYNC);
+    USART_Transmit(type);
+    USART_Transmit(seq);
+    USART_Transmit(arg);
+    USART_Transmit(crc);
+    return TRUE;
+}
+
+static void receiveFrame(uint8_t type, uint8_t seq, uint8_t arg) {
+    if( type == LINK_ACK ) {
+        if( queueCount != 0 && inFlight == TRUE && seq == queueSeq[queueHead] ) {
+            queueHead = (queueHead + 1) & (VERSUS_QUEUE_SIZE - 1);
+            queueCount--;
+            inFlight = FALSE;           /* next message goes out on this poll */
+        }
+        return;
+    }
+
+    /* after a restart of either board the numbering of the peer is taken over */
+    if( type == LINK_RESYNC || rxSynced == FALSE ) {
+        rxExpected = seq;
+        rxSynced = TRUE;
+    }
+    /* a duplicate is acked again, its first ack may have been lost */
+    if( seq == (uint8_t)(rxExpected - 1) ) {
+        sendFrame(LINK_ACK, seq, 0);
+        return;
+    }
+    /* anything else is not acked, the sender keeps it until the numbering matches */
+    if( seq != rxExpected ) return;
+    sendFrame(LINK_ACK, seq, 0);
+    rxExpected++;
+
+    if( type == LINK_GARBAGE ) {
+        garbagePending += arg;
+    }
+    else if( type == LINK_LOST ) {
+        peerLost = TRUE;
+    }
+}
+
+void versusInit() {
+    USART_Init();
+    tickTimerStartPeriodic(TIMER_LINK_PING, VERSUS_PING_TICKS);
+    versusSend(LINK_RESYNC, 0);
+}
+
+void versusPoll() {
+    uint8_t data;
+
+    while( USART_Receive(&data) == TRUE ) {
+        if( frameIndex == 0 ) {
+            if( data == VERSUS_SYNC ) frameIndex = 1;
+            continue;
+        }
+        frame[frameIndex - 1] = data;
+        frameIndex++;
+        if( frameIndex == VERSUS_FRAME_BYTES ) {
+            uint8_t crc = 0;
+            crc = _crc8_ccitt_update(crc, frame[0]);
+            crc = _crc8_ccitt_update(crc, frame[1]);
+            crc = _crc8_ccitt_update(crc, frame[2]);
+            /* a damaged frame is dropped, the sender repeats it */
+            if( crc == frame[3] ) receiveFrame(frame[0], frame[1], frame[2]);
+            frameIndex = 0;
+        }
+    }
+
+    if( tickTimerExpired(TIMER_LINK_PING) && queueCount == 0 ) {
+        versusSend(LINK_PING, 0);
+    }
+
+    if( queueCount != 0 && (inFlight == FALSE || tickTimerExpired(TIMER_LINK_RETRY)) ) {
+        if( sendFrame(queueType[queueHead], queueSeq[queueHead], queueArg[queueHead]) == TRUE ) {
+            inFlight = TRUE;
+            tickTimerStart(TIMER_LINK_RETRY, VERSUS_RETRY_TICKS);
+        }
+    }
+}
+
+uint8_t versusSend(LinkMessage type, uint8_t arg) {
+    uint8_t slot;
+    /* a top out must reach the peer, so other messages leave it one slot */
+    uint8_t size = type == LINK_LOST ? VERSUS_QUEUE_SIZE : VERSUS_QUEUE_SIZE - 1;
+
+    if( queueCount >= size ) {
+        /* garbage is additive, so it can join the last message if not yet sent */
+        slot = (queueHead + queueCount - 1) & (VERSUS_QUEUE_SIZE - 1);
+        if( type == LINK_GARBAGE && queueType[slot] == LINK_GARBAGE && queueCount > 1 ) {
+            queueArg[slot] += arg;
+            return TRUE;
+        }
+        return FALSE;
+    }
+    slot = (queueHead + queueCount) & (VERSUS_QUEUE_SIZE - 1);
+    queueType[slot] = type;
+    queueSeq[slot] = txSeq++;
+    queueArg[slot] = arg;
+    queueCount++;
+    return TRUE;
+}
+
+void versusLinesCleared(uint8_t lines) {
+    if( lines < 2 ) return;
+    versusSend(LINK_GARBAGE, lines == 4 ? 4 : lines - 1);
+}
+
+uint8_t versusTakeGarbage() {
+    uint8_t lines = garbagePending;
+    garbagePending = 0;
+    return lines;
+}
+
+uint8_t versusPeerLost() {
+    return peerLost;
+}
+
+void versusGameOver() {
+    if( peerLost == TRUE ) return;
+    versusSend(LINK_LOST, 0);
+    versusPoll();
+}
+
+void versusRestart() {
+    peerLost = FALSE;
+    garbagePending = 0;
+}
+
+#endif /* VERSUS_ENABLE */
@@ -0,0 +1,115 @@
+/*
+ * @file Versus.h
+ * @author: JZimnol
+ * @brief File containing optional two-board versus mode over the USART link
+ */ 
+
+
+#ifndef VERSUS_H_
+#define VERSUS_H_
+
+#include "Config.h"
+
+#ifdef VERSUS_ENABLE
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+/*
+ * @brief Frame layout: SYNC | type | seq | arg | CRC-8 (type, seq, arg).
+ *        Every frame except an ack carries its own sequence number and is
+ *        sent again until the peer acks it; one frame is in flight at a time.
+ *        A board starts with LINK_RESYNC, which makes the peer take its
+ *        numbering, and takes the numbering of the first frame it receives.
+ */
+#define VERSUS_SYNC             0x7e
+#define VERSUS_FRAME_BYTES      5
+#define VERSUS_QUEUE_SIZE       4     /* messages waiting to be sent, power of two;
+                                         the last slot is kept for LINK_LOST */
+#define VERSUS_RETRY_TICKS      40    /* ~20 ms without an ack -> send again */
+#define VERSUS_PING_TICKS       500   /* ~0.25 s keepalive while the queue is empty */
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Types of frames
+ */
+typedef enum {
+    LINK_ACK     = (uint8_t)'A',      /* seq of the acknowledged frame */
+    LINK_PING    = (uint8_t)'P',      /* keepalive, nothing to deliver */
+    LINK_GARBAGE = (uint8_t)'G',      /* arg = garbage rows for the peer */
+    LINK_LOST    = (uint8_t)'L',      /* sender topped out */
+    LINK_RESYNC  = (uint8_t)'R'       /* sender restarted, seq is its first one */
+} LinkMessage;
+
+/*************************************************************************\
+                                 MACROS
+\*************************************************************************/
+
+#define VERSUS_INIT()               versusInit()
+#define VERSUS_POLL()               versusPoll()
+#define VERSUS_LINES_CLEARED(n)     versusLinesCleared(n)
+#define VERSUS_TAKE_GARBAGE()       versusTakeGarbage()
+#define VERSUS_PEER_LOST()          versusPeerLost()
+#define VERSUS_GAME_OVER()          versusGameOver()
+#define VERSUS_RESTART()            versusRestart()
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief start the USART (transmitter and receiver) and the keepalive,
+ *        queue LINK_RESYNC for the peer
+ */
+void versusInit();
+/*
+ * @brief parse received frames, send acks, (re)send the head of the queue;
+ *        call from the main loop
+ */
+void versusPoll();
+/*
+ * @brief queue a message for the peer
+ * @param message type and argument
+ * @return true if queued, false if the queue is full (LINK_LOST may use
+ *         the last slot)
+ */
+uint8_t versusSend(LinkMessage type, uint8_t arg);
+/*
+ * @brief send garbage for rows cleared by one block (2 -> 1, 3 -> 2, 4 -> 4)
+ * @param rows cleared at once
+ */
+void versusLinesCleared(uint8_t lines);
+/*
+ * @brief take garbage rows received since the last call
+ * @return rows to add under the floor
+ */
+uint8_t versusTakeGarbage();
+/*
+ * @brief check if the peer has topped out
+ * @return true if the peer lost
+ */
+uint8_t versusPeerLost();
+/*
+ * @brief tell the peer this board lost (unless the peer lost first)
+ */
+void versusGameOver();
+/*
+ * @brief forget the result and the garbage of the previous game
+ */
+void versusRestart();
+
+#else
+
+#define VERSUS_INIT()
+#define VERSUS_POLL()
+#define VERSUS_LINES_CLEARED(n)
+#define VERSUS_TAKE_GARBAGE()       0
+#define VERSUS_PEER_LOST()          FALSE
+#define VERSUS_GAME_OVER()
+#define VERSUS_RESTART()
+
+#endif /* VERSUS_ENABLE */
+
+#endif /* VERSUS_H_ */
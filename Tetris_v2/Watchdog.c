@@ -0,0 +1,137 @@
+/*
+ * @file Watchdog.c
+ * @author: JZimnol
+ * @brief File containing definitions for overrun detection and the reset log
+ */ 
+
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#include <util/atomic.h>
+#include "Tetris.h"
+#include "Watchdog.h"
+#include "Tick.h"
+
+#ifdef WATCHDOG_ENABLE
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Kept in .noinit, so it survives a watchdog or external reset (not
+ *        a power loss) and the counts of a run that hung are not lost
+ */
+typedef struct {
+    uint8_t magic;
+    uint32_t base;                  /* overruns of all runs before this one */
+    uint16_t overruns;              /* overruns of this run */
+    uint16_t check;                 /* ~overruns, tells a warm reset from garbage */
+} WarmState;
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+/* in .noinit too, so the boot after a hang can tell which task hung */
+volatile uint8_t watchdogTask __attribute__((section(".noinit")));
+static volatile WarmState warm __attribute__((section(".noinit")));
+static uint8_t resetFlags __attribute__((section(".noinit")));
+static WatchdogLog savedLog EEMEM;
+static WatchdogLog wdLog;               /* RAM copy of savedLog */
+static uint16_t loggedOverruns;         /* overruns of this run already in wdLog */
+static uint8_t writePending = FALSE;
+static uint8_t writeIndex;
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * Runs from .init3, before .bss is cleared. A watchdog reset leaves the
+ * watchdog running with its shortest timeout, so it is stopped at once, and
+ * MCUSR is saved and cleared (WDRF keeps the watchdog on while it is set).
+ */
+void watchdogEarly() __attribute__((naked, used, section(".init3")));
+void watchdogEarly() {
+    resetFlags = MCUSR;
+    MCUSR = 0;
+    wdt_disable();
+}
+
+static uint8_t resetCause() {
+    /* a power up often sets BORF too; after PORF the other flags mean nothing */
+    if( resetFlags & (1<<PORF) ) return RESET_POWER_ON;
+    if( resetFlags & (1<<WDRF) ) return RESET_WATCHDOG;
+    if( resetFlags & (1<<BORF) ) return RESET_BROWN_OUT;
+    if( resetFlags & (1<<EXTRF) ) return RESET_EXTERNAL;
+    return RESET_UNKNOWN;
+}
+
+void watchdogInit() {
+    uint8_t cause = resetCause();
+
+    eeprom_read_block(&wdLog, &savedLog, sizeof(WatchdogLog));
+    if( wdLog.magic != WATCHDOG_MAGIC ) {
+        uint8_t *p = (uint8_t *)&wdLog;
+        for( uint8_t i=0; i<sizeof(WatchdogLog); i++ ) {
+            p[i] = 0;
+        }
+        wdLog.magic = WATCHDOG_MAGIC;
+        wdLog.hangTask = WATCHDOG_IDLE;
+    }
+    /* the last run may have ended before its overruns were written */
+    if( cause != RESET_POWER_ON && warm.magic == WATCHDOG_MAGIC && (uint16_t)(warm.check ^ warm.overruns) == 0xffff ) {
+        wdLog.overruns = warm.base + warm.overruns;
+        if( cause == RESET_WATCHDOG ) wdLog.hangTask = watchdogTask;
+    }
+    wdLog.lastCause = cause;
+    if( wdLog.resets[cause] != 0xffff ) wdLog.resets[cause]++;
+    eeprom_update_block(&wdLog, &savedLog, sizeof(WatchdogLog));
+
+    watchdogTask = WATCHDOG_IDLE;
+    warm.magic = WATCHDOG_MAGIC;
+    warm.base = wdLog.overruns;
+    warm.overruns = 0;
+    warm.check = 0xffff;
+    loggedOverruns = 0;
+
+    tickTimerStartPeriodic(TIMER_WATCHDOG, WATCHDOG_LOG_TICKS);
+    wdt_enable(WATCHDOG_TIMEOUT);
+}
+
+void watchdogPoll() {
+    const uint8_t *data = (const uint8_t *)&wdLog;
+    uint8_t *target = (uint8_t *)&savedLog;
+
+    if( writePending == FALSE ) {
+        uint16_t overruns;
+
+        if( tickTimerExpired(TIMER_WATCHDOG) == FALSE ) return;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            overruns = warm.overruns;
+        }
+        if( overruns == loggedOverruns ) return;
+        loggedOverruns = overruns;
+        wdLog.overruns = warm.base + overruns;
+        writePending = TRUE;
+        writeIndex = 0;
+    }
+    if( !eeprom_is_ready() ) return;
+
+    /* reading is fast; only bytes that differ cost a 3.4 ms write cycle */
+    while( writeIndex < sizeof(WatchdogLog) ) {
+        uint8_t i = writeIndex++;
+        if( eeprom_read_byte(target + i) != data[i] ) {
+            eeprom_write_byte(target + i, data[i]);
+            return;
+        }
+    }
+    writePending = FALSE;
+}
+
+void watchdogOverrun() {
+    if( warm.overruns == 0xffff ) return;
+    warm.overruns++;
+    warm.check = ~warm.overruns;
+}
+
+#endif /* WATCHDOG_ENABLE */
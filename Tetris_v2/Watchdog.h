@@ -0,0 +1,102 @@
+/*
+ * @file Watchdog.h
+ * @author: JZimnol
+ * @brief File containing refresh ISR overrun detection, the watchdog and a
+ *        reset log kept in EEPROM
+ */ 
+
+
+#ifndef WATCHDOG_H_
+#define WATCHDOG_H_
+
+#include "Config.h"
+
+#ifdef WATCHDOG_ENABLE
+
+#include <avr/wdt.h>
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+
+#define WATCHDOG_TIMEOUT    WDTO_250MS  /* main loop stuck for this long -> reset */
+#define WATCHDOG_MAGIC      0x57
+#define WATCHDOG_IDLE       0xff        /* no task running */
+#define WATCHDOG_LOG_TICKS  TICKS_FROM_MS(10000)    /* new overruns are written every ~10 s */
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Cause of a reset, from MCUSR
+ */
+typedef enum {
+    RESET_POWER_ON  = (uint8_t)0,
+    RESET_EXTERNAL  = (uint8_t)1,    /* reset pin */
+    RESET_BROWN_OUT = (uint8_t)2,
+    RESET_WATCHDOG  = (uint8_t)3,    /* the main loop hung */
+    RESET_UNKNOWN   = (uint8_t)4,    /* no flag: jump to address 0 (crash) or a bootloader cleared it */
+    RESET_COUNT     = (uint8_t)5
+} ResetCause;
+/*
+ * @brief Log in EEPROM; read it with avrdude -U eeprom:r:eeprom.hex:i.
+ *        Counters keep counting across power cycles.
+ */
+typedef struct {
+    uint8_t magic;
+    uint8_t lastCause;              /* ResetCause of the last reset */
+    uint8_t hangTask;               /* TaskId running at the last watchdog reset, 0xff: none */
+    uint16_t resets[RESET_COUNT];   /* resets by cause */
+    uint32_t overruns;              /* refresh ISRs that ended after the next compare */
+} WatchdogLog;
+
+/*************************************************************************\
+                                 MACROS
+\*************************************************************************/
+
+#define WATCHDOG_INIT()         watchdogInit()
+#define WATCHDOG_FEED()         wdt_reset()
+#define WATCHDOG_POLL()         watchdogPoll()
+#define WATCHDOG_TASK(id)       (watchdogTask = (id))
+/*
+ * @brief end of the refresh ISR: the compare flag is set again when the ISR
+ *        took longer than its slot, so the slot started late or was lost
+ */
+#define WATCHDOG_ISR_EXIT()     do { if( TIFR0 & (1<<OCF0A) ) watchdogOverrun(); } while(0)
+
+/*************************************************************************\
+                            VARIABLE DECLARATIONS
+\*************************************************************************/
+
+extern volatile uint8_t watchdogTask;  /* task being run, WATCHDOG_IDLE between tasks */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief log the cause of the last reset and start the watchdog; call
+ *        before sei(), it may wait for a few EEPROM writes
+ */
+void watchdogInit();
+/*
+ * @brief write changed counters to EEPROM, one byte per call; call from
+ *        the main loop
+ */
+void watchdogPoll();
+/*
+ * @brief count one overrun; call from the refresh ISR only
+ */
+void watchdogOverrun();
+
+#else
+
+#define WATCHDOG_INIT()
+#define WATCHDOG_FEED()
+#define WATCHDOG_POLL()
+#define WATCHDOG_TASK(id)
+#define WATCHDOG_ISR_EXIT()
+
+#endif /* WATCHDOG_ENABLE */
+
+#endif /* WATCHDOG_H_ */
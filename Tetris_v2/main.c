@@ -3,59 +3,142 @@
 #include <avr/io.h>          /* AVR core lib */
 #include <avr/interrupt.h>   /* AVR interrupt lib */
 #include "Tetris.h"
+#include "Profiler.h"
+#include "FrameStream.h"
+#include "Scan.h"
+#include "Tick.h"
+#include "Save.h"
+#include "Memory.h"
+#include "Versus.h"
+#include "Input.h"
+#include "Logic.h"
+#include "Scheduler.h"
+#include "Animation.h"
+#include "Game.h"
+#include "Sound.h"
+#include "Display.h"
+#include "Watchdog.h"
+#include "Remote.h"
+
+/*************************************************************************\
+                                  TASKS
+\*************************************************************************/
+
+/* buttons and remote actions go to the game state machine in every state */
+static void taskInput(Task *task) {
+    uint8_t input = inputRead();
+    if( input != INPUT_NONE && gameEvent(EVENT_BUTTON, input) == EVENT_DROPPED ) task->stats.dropped++;
+    REMOTE_POLL();
+}
+
+static void taskGravity(Task *task) {
+#ifdef LOGIC_TICK_ENABLE
+    logicTick();
+#else
+    moveBlockDown();
+    task->period = GRAVITY_TICKS(lvl);      /* the level may have changed */
+#endif
+}
+
+/* keyframes; the splash and game over flow is driven by Game.c */
+static void taskAnimation(Task *task) {
+    animationStep();
+}
+
+static void taskRender(Task *task) {
+    FRAME_PUBLISH();
+}
+
+static void taskBackground(Task *task) {
+    SAVE_POLL();
+    VERSUS_POLL();
+    SOUND_POLL();
+    WATCHDOG_POLL();
+    if( VERSUS_PEER_LOST() ) GameOver();
+}
+
+static void taskTelemetry(Task *task) {
+    PROFILE_POLL();
+    FRAMESTREAM_POLL();
+    MEMORY_POLL();
+    schedReport();
+}
+
+/*
+ * Task table in priority order. Gravity runs only while the game is played.
+ * Periods and deadlines are in 0.512 ms ticks; the gravity period follows
+ * the level.
+ */
+Task tasks[TASK_COUNT] = {
+    /*                   body            period  deadline  enabled */
+    [TASK_INPUT]      = { taskInput,      1,      2,        TRUE },
+#ifdef LOGIC_TICK_ENABLE
+    [TASK_GRAVITY]    = { taskGravity,    LOGIC_TICK_PERIOD, LOGIC_TICK_DEADLINE, FALSE },
+#else
+    [TASK_GRAVITY]    = { taskGravity,    GRAVITY_TICKS(0), 8, FALSE },
+#endif
+    [TASK_ANIMATION]  = { taskAnimation,  1,      4,        TRUE },
+    [TASK_RENDER]     = { taskRender,     1,      4,        TRUE },
+    [TASK_BACKGROUND] = { taskBackground, 1,      8,        TRUE },
+    [TASK_TELEMETRY]  = { taskTelemetry,  1,      16,       TRUE }
+};
+
+/*************************************************************************\
+                                   MAIN
+\*************************************************************************/
 
 int main(void) {
     
+    WATCHDOG_INIT();
     buttonsInit();
-    SPI_MasterInit();
+    DISPLAY_INIT();
     TIM0_Init();
+    PROFILE_INIT();
+    FRAMESTREAM_INIT();
+    MEMORY_INIT();
+    VERSUS_INIT();
+    SOUND_INIT();
+    REMOTE_INIT();
     sei();			  
-
-    displayPLAY();
-    while( !PC1_PUSHED )
-        ;
-
-    timer_ms = 0;
-    while( timer_ms < 250 )
-        ;
-
-    framebufferInit();
-    displayNewBlock();
+    schedInit();
+    gameInit();
 
     /* buttons control has been implemented using polling, but there are 
        no contraindications to use interrupts */
     while(1) {  
-        if( timer_ms > ((500 - lvl)<<1) ) {
-            moveBlockDown();
-            timer_ms = 0;
-        }
-        if( PC2_PUSHED && debounce > 300 ) {
-            moveBlockLeft();
-            debounce = 0;
-        }
-        if( PC3_PUSHED && debounce > 300 ) {
-            moveBlockDown();
-            debounce = 0;
-        }
-        if( PC0_PUSHED && debounce > 300 ) {
-            moveBlockRight();
-            debounce = 0;
-        }
-        if( PC1_PUSHED && debounce > 300 ) {
-            rotateBlockRight();
-            debounce = 0;
-        }
+        schedRun();
+        /* only the loop feeds the watchdog, a stuck task or a refresh ISR
+           that never lets it run ends in a reset */
+        WATCHDOG_FEED();
     }
     return (0);
 }
 
+#if defined(DISPLAY_MAX7219)
+/* interruption every 0.512 ms; the drivers scan the display, only the timebase is kept */
+ISR(TIMER0_COMPA_vect) {
+        PROFILE_BEGIN(PROF_REFRESH_ISR);
+        TICK_ADVANCE(1);
+        PROFILE_END(PROF_REFRESH_ISR);
+        WATCHDOG_ISR_EXIT();
+}
+#elif defined(SCAN_SKIP_BLANK_ROWS)
+/* interruption at the end of every row slot; slots have variable length */
+ISR(TIMER0_COMPA_vect) {
+        PROFILE_BEGIN(PROF_REFRESH_ISR);
+        TICK_ADVANCE(scanNextRow());
+        PROFILE_END(PROF_REFRESH_ISR);
+        WATCHDOG_ISR_EXIT();
+}
+#else
 /* interruption every 0.512 ms */
 ISR(TIMER0_COMPA_vect) {
-        timer_ms++;
-        debounce++;
-        SPI_MasterTransmit_16bit(~frameBuffer.main[iteratorSPI]);  /* send frame buffer */
-        /* 0x80000000 == 0b10000000000000000000000000000000 */
-        SPI_MasterTransmit_32bit(0x80000000>>iteratorSPI);         /* send one-hot row */
+        PROFILE_BEGIN(PROF_REFRESH_ISR);
+        TICK_ADVANCE(1);
+        SPI_MasterTransmitRow(iteratorSPI);     /* columns of every panel and one-hot row */
         iteratorSPI++;
         if (iteratorSPI == 32) iteratorSPI = 0;
+        PROFILE_END(PROF_REFRESH_ISR);
+        WATCHDOG_ISR_EXIT();
 }
+#endif /* DISPLAY_MAX7219 */
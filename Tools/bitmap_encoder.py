@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""
+@file bitmap_encoder.py
+@author: JZimnol
+@brief Compress the 16 pixel wide bitmaps of an art file into the stream
+       format decoded by Tetris_v2/Bitmap.c
+
+usage: bitmap_encoder.py [Tools/bitmaps.txt] > tables.c
+
+An art file has one section per bitmap. "[name]" starts a full image,
+"[name < base]" an image stored as the rows that differ from bitmap base
+(a delta frame, only valid when drawn over base). Rows are 16 characters,
+'#' is a lit pixel and '.' a dark one; ';' starts a comment line.
+
+Stream codes (one byte, n = low 6 bits, 1..63):
+    0x00        end
+    0x00 | n    n rows of the last literal value (0 before the first literal)
+    0x40 | n    n literal rows follow, two bytes each, high byte first
+    0x80 | n    n rows are left as they are
+"""
+
+import os
+import re
+import sys
+
+DEFAULT_ART = os.path.join(os.path.dirname(os.path.abspath(__file__)), "bitmaps.txt")
+MAX_RUN = 63
+
+
+def parse(path):
+    bitmaps, order = {}, []
+    current = None
+    with open(path) as art:
+        for number, line in enumerate(art, 1):
+            line = line.strip()
+            header = re.match(r"^\[(\w+)(?:\s*<\s*(\w+))?\]$", line)
+            if header:
+                name, base = header.groups()
+                current = {"base": base, "rows": []}
+                bitmaps[name] = current
+                order.append(name)
+            elif re.match(r"^[#.]{16}$", line) and current is not None:
+                current["rows"].append(int(line.replace("#", "1").replace(".", "0"), 2))
+            elif line and not line.startswith(";"):
+                sys.exit("%s:%d: expected a section or a 16 pixel row" % (path, number))
+    return bitmaps, order
+
+
+def encode(rows, base=None):
+    """Stream bytes of rows; unchanged rows against base are skipped."""
+    out, previous, i = [], 0, 0
+    while i < len(rows):
+        if base is not None and rows[i] == base[i]:
+            n = 1
+            while i + n < len(rows) and n < MAX_RUN and rows[i + n] == base[i + n]:
+                n += 1
+            out.append(0x80 | n)
+        elif rows[i] == previous:
+            n = 1
+            while i + n < len(rows) and n < MAX_RUN and rows[i + n] == previous \
+                    and not (base is not None and rows[i + n] == base[i + n]):
+                n += 1
+            out.append(n)
+        else:
+            n = 1
+            # the first row of a run ends the literal, the rest is repeated
+            while i + n < len(rows) and n < MAX_RUN and rows[i + n] != rows[i + n - 1] \
+                    and not (base is not None and rows[i + n] == base[i + n]):
+                n += 1
+            out.append(0x40 | n)
+            for row in rows[i:i + n]:
+                out += [row >> 8, row & 0xff]
+            previous = rows[i + n - 1]
+        i += n
+    return out + [0x00]
+
+
+def main():
+    path = sys.argv[1] if len(sys.argv) > 1 else DEFAULT_ART
+    bitmaps, order = parse(path)
+    total_raw = total_packed = 0
+    for name in order:
+        bitmap = bitmaps[name]
+        base = None
+        if bitmap["base"]:
+            base = bitmaps[bitmap["base"]]["rows"]
+            if len(base) != len(bitmap["rows"]):
+                sys.exit("%s: %s and its base differ in height" % (path, name))
+        data = encode(bitmap["rows"], base)
+        raw = 2 * len(bitmap["rows"])
+        total_raw += raw
+        total_packed += len(data)
+        kind = "delta of %s" % bitmap["base"] if base else "image"
+        print("/* %s: %d rows, %s, %d bytes (%d raw) */" % (name, len(bitmap["rows"]), kind, len(data), raw))
+        print("static const uint8_t %sBitmap[] PROGMEM = {" % re.sub(r"_(\w)", lambda m: m.group(1).upper(), name))
+        for start in range(0, len(data), 12):
+            print("    " + ", ".join("0x%02x" % b for b in data[start:start + 12]) + ",")
+        print("};\n")
+    print("/* total %d bytes, %d raw */" % (total_packed, total_raw))
+
+
+if __name__ == "__main__":
+    main()
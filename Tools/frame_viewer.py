@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+"""
+@file frame_viewer.py
+@author: JZimnol
+@brief Mirror of the LED matrix rebuilt from PACKET_FRAME_DELTA packets sent by
+       a FRAMESTREAM_ENABLE build
+
+usage: frame_viewer.py /dev/ttyUSB0 [baud] [--record file]
+       frame_viewer.py recorded_file          (replay a recording)
+"""
+
+import sys
+
+from telemetry import open_serial, packets
+
+PACKET_FRAME_DELTA = ord("F")
+ROWS = 32
+COLUMNS = 16
+
+
+class Recorder:
+    """Pass-through stream that stores every received byte."""
+
+    def __init__(self, stream, path):
+        self.stream = stream
+        self.out = open(path, "wb")
+
+    def read(self, size):
+        data = self.stream.read(size)
+        self.out.write(data)
+        self.out.flush()
+        return data
+
+
+def render(frame, stats):
+    lines = ["\x1b[H"]
+    for row in range(ROWS):
+        bits = frame[row]
+        # bit 15 is the leftmost column (blocks move left with <<1)
+        lines.append("".join("##" if bits & (1 << (COLUMNS - 1 - col)) else ". "
+                             for col in range(COLUMNS)))
+    lines.append("packets %(packets)d  rows %(rows)d  bytes %(bytes)d  "
+                 "avg bytes/packet %(avg).1f   " % stats)
+    sys.stdout.write("\n".join(lines) + "\n")
+    sys.stdout.flush()
+
+
+def main():
+    args = sys.argv[1:]
+    if not args:
+        sys.exit(__doc__)
+    record = None
+    if "--record" in args:
+        index = args.index("--record")
+        record = args[index + 1]
+        del args[index:index + 2]
+    baud = int(args[1]) if len(args) > 1 else 500000
+    stream = open_serial(args[0], baud)
+    if record:
+        stream = Recorder(stream, record)
+
+    frame = [0] * ROWS
+    stats = {"packets": 0, "rows": 0, "bytes": 0, "avg": 0.0}
+    sys.stdout.write("\x1b[2J")
+    for kind, payload in packets(stream):
+        if kind != PACKET_FRAME_DELTA or len(payload) % 3:
+            continue
+        for i in range(0, len(payload), 3):
+            row = payload[i]
+            if row < ROWS:
+                frame[row] = payload[i + 1] | (payload[i + 2] << 8)
+        stats["packets"] += 1
+        stats["rows"] += len(payload) // 3
+        stats["bytes"] += len(payload) + 4
+        stats["avg"] = stats["bytes"] / stats["packets"]
+        render(frame, stats)
+
+
+if __name__ == "__main__":
+    main()
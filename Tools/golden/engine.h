@@ -0,0 +1,64 @@
+/*
+ * @file engine.h
+ * @author: JZimnol
+ * @brief Common interface of the engines compared by the golden trace harness.
+ *        Every adapter (engine_v1.c, engine_v2.c) maps it onto one game.
+ */ 
+
+#ifndef ENGINE_H_
+#define ENGINE_H_
+
+#include <stdint.h>
+#include <setjmp.h>
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+
+#define ENGINE_BOARD_FIRST  7     /* top line of the playfield */
+#define ENGINE_BOARD_ROWS   25    /* rows 7..31 are compared */
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Player actions; gravity is an ordinary ACTION_DOWN
+ */
+typedef enum {
+    ACTION_LEFT   = 'L',
+    ACTION_RIGHT  = 'R',
+    ACTION_DOWN   = 'D',
+    ACTION_ROTATE = 'U'
+} Action;
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+extern jmp_buf engineOverJump;    /* game over of the engine jumps back here */
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief start a game; the block sequence depends on the seed only
+ * @param non-zero seed of the xorshift block generator
+ */
+void engineReset(uint16_t seed);
+/*
+ * @brief apply one action
+ * @param action
+ */
+void engineStep(Action action);
+/*
+ * @brief visible playfield, floor and falling block together
+ * @param destination of ENGINE_BOARD_ROWS rows
+ */
+void engineBoard(uint16_t *rows);
+/*
+ * @brief points counter
+ */
+uint16_t enginePoints();
+
+#endif /* ENGINE_H_ */
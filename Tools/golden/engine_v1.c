@@ -0,0 +1,89 @@
+/*
+ * @file engine_v1.c
+ * @author: JZimnol
+ * @brief Golden trace adapter of Tetris_v1/main.c. The game is compiled
+ *        unmodified; its gameover() is made weak and replaced here.
+ */ 
+
+#include "engine.h"
+
+/*************************************************************************\
+                            TETRIS_V1 INTERFACE
+\*************************************************************************/
+
+extern uint16_t fb_main[32];
+extern uint16_t points;
+extern volatile uint16_t tim_ms;
+extern uint8_t nextblock;
+
+void fb_init();
+void newblock();
+int spacedown();
+void movedown();
+void moveleft();
+void moveright();
+void rotateRight();
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+jmp_buf engineOverJump;
+static uint16_t randomState;
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/* same xorshift as randomBlock() of Tetris_v2 */
+static uint8_t randomBlock() {
+    randomState ^= randomState<<7;
+    randomState ^= randomState>>9;
+    randomState ^= randomState<<8;
+    return randomState % 7;
+}
+
+void gameover() {
+    longjmp(engineOverJump, 1);
+}
+
+void engineReset(uint16_t seed) {
+    randomState = seed | 1;
+    fb_init();
+    /* v1 draws the next block from tim_ms, so it always holds the one after it */
+    nextblock = randomBlock();
+    tim_ms = randomBlock();
+    newblock();
+    tim_ms = randomBlock();
+}
+
+void engineStep(Action action) {
+    switch( action ) {
+        case ACTION_LEFT:
+            moveleft();
+            break;
+        case ACTION_RIGHT:
+            moveright();
+            break;
+        case ACTION_ROTATE:
+            rotateRight();
+            break;
+        case ACTION_DOWN: {
+            /* a block that cannot fall locks and newblock() consumes tim_ms */
+            int locks = !spacedown();
+            movedown();
+            if( locks ) tim_ms = randomBlock();
+            break;
+        }
+    }
+}
+
+void engineBoard(uint16_t *rows) {
+    for( uint8_t i=0; i<ENGINE_BOARD_ROWS; i++ ) {
+        rows[i] = fb_main[ENGINE_BOARD_FIRST + i];
+    }
+}
+
+uint16_t enginePoints() {
+    return points;
+}
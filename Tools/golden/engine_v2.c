@@ -0,0 +1,78 @@
+/*
+ * @file engine_v2.c
+ * @author: JZimnol
+ * @brief Golden trace adapter of Tetris_v2/Tetris.c. The game is compiled
+ *        unmodified; its GameOver() is made weak and replaced here, the tick
+ *        service is replaced by a constant clock that returns the seed.
+ */ 
+
+#include "engine.h"
+#include "Tetris.h"
+#include "Tick.h"
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+jmp_buf engineOverJump;
+static uint16_t engineSeed;
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/* framebufferInit() seeds the block generator from the clock */
+uint32_t tickNow() {
+    return engineSeed;
+}
+
+/* only called by revisions before the scheduler (v2@REV) */
+void tickDelay(uint16_t ticks) {
+}
+
+void GameOver() {
+    longjmp(engineOverJump, 1);
+}
+
+/* the splash screen is decoded by Bitmap.c, which is not built */
+uint8_t bitmapDraw(uint8_t id, uint16_t *rows, uint8_t count) {
+    return 0;
+}
+
+void engineReset(uint16_t seed) {
+    engineSeed = seed;
+    framebufferInit();
+    displayNewBlock();
+}
+
+void engineStep(Action action) {
+    switch( action ) {
+        case ACTION_LEFT:
+            moveBlockLeft();
+            break;
+        case ACTION_RIGHT:
+            moveBlockRight();
+            break;
+        case ACTION_ROTATE:
+            rotateBlockRight();
+            break;
+        case ACTION_DOWN:
+            moveBlockDown();
+            break;
+    }
+}
+
+void engineBoard(uint16_t *rows) {
+#ifdef FRAME_PUBLISH
+    /* the game only marks the frame changed, compose it like the render task;
+       only v2@REV revisions from before framePublish() lack the macro */
+    FRAME_PUBLISH();
+#endif
+    for( uint8_t i=0; i<ENGINE_BOARD_ROWS; i++ ) {
+        rows[i] = frameBuffer.main[ENGINE_BOARD_FIRST + i];
+    }
+}
+
+uint16_t enginePoints() {
+    return pointsCounter;
+}
@@ -0,0 +1,54 @@
+/*
+ * @file runner.c
+ * @author: JZimnol
+ * @brief Plays one seeded action sequence on an engine and prints the board
+ *        after every step; golden_trace.py compares two of these traces
+ *
+ * usage: engine seed actions      (actions: string of L, R, D and U)
+ * output: one line per step, "step action points row7 .. row31" in hex,
+ *         then "over" if the game ended
+ */ 
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "engine.h"
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+static void printState(unsigned step, char action) {
+    uint16_t rows[ENGINE_BOARD_ROWS];
+
+    engineBoard(rows);
+    printf("%u %c %u", step, action, enginePoints());
+    for( int i=0; i<ENGINE_BOARD_ROWS; i++ ) {
+        printf(" %04x", rows[i]);
+    }
+    printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+    /* volatile: the step counter must survive the longjmp of a game over */
+    volatile unsigned step = 0;
+    const char *actions;
+
+    if( argc != 3 ) {
+        fprintf(stderr, "usage: %s seed actions\n", argv[0]);
+        return 2;
+    }
+    actions = argv[2];
+
+    if( setjmp(engineOverJump) ) {
+        printf("over %u %u\n", step, enginePoints());
+        return 0;
+    }
+    engineReset((uint16_t)strtoul(argv[1], NULL, 0));
+    printState(0, '-');
+    for( step=1; step<=strlen(actions); step++ ) {
+        engineStep((Action)actions[step - 1]);
+        printState(step, actions[step - 1]);
+    }
+    return 0;
+}
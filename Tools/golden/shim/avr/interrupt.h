@@ -0,0 +1,14 @@
+/*
+ * @file interrupt.h
+ * @author: JZimnol
+ * @brief Host stand-in for <avr/interrupt.h>; handlers become plain functions
+ */ 
+
+#ifndef SHIM_AVR_INTERRUPT_H_
+#define SHIM_AVR_INTERRUPT_H_
+
+#define ISR(vector)     void vector(void); void vector(void)
+#define sei()
+#define cli()
+
+#endif /* SHIM_AVR_INTERRUPT_H_ */
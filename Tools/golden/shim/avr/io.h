@@ -0,0 +1,45 @@
+/*
+ * @file io.h
+ * @author: JZimnol
+ * @brief Host stand-in for <avr/io.h>: every I/O register is a plain byte,
+ *        so the game logic compiles and runs on the build machine
+ */ 
+
+#ifndef SHIM_AVR_IO_H_
+#define SHIM_AVR_IO_H_
+
+#include <stdint.h>
+
+static volatile uint8_t shimRegisters[0x100] __attribute__((unused));
+
+#define DDRB    shimRegisters[0x24]
+#define PORTB   shimRegisters[0x25]
+#define PINC    shimRegisters[0x26]
+#define DDRC    shimRegisters[0x27]
+#define PORTC   shimRegisters[0x28]
+#define TCCR0A  shimRegisters[0x44]
+#define TCCR0B  shimRegisters[0x45]
+#define OCR0A   shimRegisters[0x47]
+#define SPCR    shimRegisters[0x4c]
+#define SPSR    shimRegisters[0x4d]
+#define SPDR    shimRegisters[0x4e]
+#define TIMSK0  shimRegisters[0x6e]
+
+#define PB2     2
+#define PB3     3
+#define PB5     5
+#define PC0     0
+#define PC1     1
+#define PC2     2
+#define PC3     3
+#define CS00    0
+#define CS02    2
+#define WGM01   1
+#define OCIE0A  1
+#define SPR0    0
+#define MSTR    4
+#define DORD    5
+#define SPE     6
+#define SPIF    7
+
+#endif /* SHIM_AVR_IO_H_ */
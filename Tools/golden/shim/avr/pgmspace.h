@@ -0,0 +1,16 @@
+/*
+ * @file pgmspace.h
+ * @author: JZimnol
+ * @brief Host stand-in for <avr/pgmspace.h>; flash tables are ordinary data
+ */ 
+
+#ifndef SHIM_AVR_PGMSPACE_H_
+#define SHIM_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+
+#define PROGMEM
+#define pgm_read_byte(addr)     (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)     (*(const uint16_t *)(addr))
+
+#endif /* SHIM_AVR_PGMSPACE_H_ */
@@ -0,0 +1,13 @@
+/*
+ * @file delay.h
+ * @author: JZimnol
+ * @brief Host stand-in for <util/delay.h>; the trace has no notion of time
+ */ 
+
+#ifndef SHIM_UTIL_DELAY_H_
+#define SHIM_UTIL_DELAY_H_
+
+#define _delay_ms(ms)
+#define _delay_us(us)
+
+#endif /* SHIM_UTIL_DELAY_H_ */
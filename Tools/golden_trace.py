@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""
+@file golden_trace.py
+@author: JZimnol
+@brief Differential test of two Tetris engines. Both play the same seeded
+       action sequences; the board and the points are compared after every
+       step and the first divergence is shrunk to a minimal failing trace.
+
+usage: golden_trace.py [--reference SPEC] [--candidate SPEC] [--seeds N]
+                       [--steps N] [-D MACRO[=VALUE] ...]
+       SPEC is v1 (Tetris_v1/main.c), v2 (Tetris_v2 in the working tree) or
+       v2@REV (Tetris_v2 at a git revision). Defaults: v2@HEAD against v2,
+       i.e. uncommitted changes against the last commit.
+       -D options are passed to every v2 build (e.g. -D PREVIEW_COUNT=2);
+       only Tetris.c is built, so options that need other modules do not link.
+
+Engines are built for the host with cc: Tools/golden/shim replaces the AVR
+headers and engine_v1.c / engine_v2.c adapt each game to engine.h. The game
+over function of the engine is made weak (objcopy) so the adapter can stop
+the run instead of spinning forever.
+"""
+
+import argparse
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+GOLDEN = os.path.join(ROOT, "Tools", "golden")
+CFLAGS = ["-std=gnu99", "-O1", "-fPIC", "-w",
+          "-I" + os.path.join(GOLDEN, "shim"), "-I" + GOLDEN]
+ACTIONS = "DDDDDLLLRRRUUUU"    # gravity dominates, like a real game
+BOARD_ROWS = 25
+
+
+def run(cmd, **kwargs):
+    return subprocess.run(cmd, check=True, **kwargs)
+
+
+def build(spec, workdir, defines):
+    """Build the engine named by spec, return the path of the executable."""
+    name = spec.replace("@", "_").replace("/", "_")
+    flags = CFLAGS
+    out = os.path.join(workdir, name)
+    game = os.path.join(workdir, name + ".o")
+    if spec == "v1":
+        run(["cc"] + CFLAGS + ["-Dmain=tetrisV1Main", "-c",
+                               os.path.join(ROOT, "Tetris_v1", "main.c"), "-o", game])
+        run(["objcopy", "--weaken-symbol=gameover", game])
+        adapter, includes = "engine_v1.c", []
+    elif spec == "v2" or spec.startswith("v2@"):
+        source = os.path.join(ROOT, "Tetris_v2")
+        if spec != "v2":
+            source = os.path.join(workdir, name + "_src")
+            os.makedirs(source)
+            archive = run(["git", "-C", ROOT, "archive", spec[3:], "Tetris_v2"],
+                          stdout=subprocess.PIPE).stdout
+            run(["tar", "-x", "-C", source], input=archive)
+            source = os.path.join(source, "Tetris_v2")
+            # revisions before the extern declarations in Tetris.h define the
+            # globals in every file that includes it
+            flags = CFLAGS + ["-fcommon"]
+        includes = ["-I" + source] + ["-D" + d for d in defines]
+        run(["cc"] + flags + includes + ["-c", os.path.join(source, "Tetris.c"), "-o", game])
+        run(["objcopy", "--weaken-symbol=GameOver", game])
+        adapter = "engine_v2.c"
+    else:
+        sys.exit("unknown engine %r" % spec)
+    run(["cc"] + flags + includes + [os.path.join(GOLDEN, adapter),
+                                     os.path.join(GOLDEN, "runner.c"), game, "-o", out])
+    return out
+
+
+def trace(engine, seed, actions):
+    out = run([engine, str(seed), actions], stdout=subprocess.PIPE, text=True).stdout
+    return out.splitlines()
+
+
+def first_divergence(engines, seed, actions):
+    """Index of the first differing trace line, None if the traces agree."""
+    ref, cand = (trace(e, seed, actions) for e in engines)
+    for i, (a, b) in enumerate(zip(ref, cand)):
+        if a != b:
+            return i
+    if len(ref) != len(cand):
+        return min(len(ref), len(cand))
+    return None
+
+
+def shrink(engines, seed, actions):
+    """Cut the sequence at the divergence, then drop chunks while it still fails."""
+    actions = actions[:first_divergence(engines, seed, actions)]
+    chunk = max(1, len(actions) // 2)
+    while chunk >= 1:
+        i = 0
+        while i < len(actions):
+            candidate = actions[:i] + actions[i + chunk:]
+            if first_divergence(engines, seed, candidate) is not None:
+                actions = candidate
+            else:
+                i += chunk
+        chunk //= 2
+    return actions
+
+
+def render(line):
+    """Board rows of a trace line as text; bit 15 is the leftmost column."""
+    fields = line.split()
+    if fields[0] == "over":
+        return ["game over, points %s" % fields[2]] + [""] * BOARD_ROWS
+    rows = [int(r, 16) for r in fields[3:]]
+    return ["points %s" % fields[2]] + [
+        "".join("#" if bits & (1 << (15 - c)) else "." for c in range(16)) for bits in rows]
+
+
+def report(names, engines, seed, actions):
+    step = first_divergence(engines, seed, actions)
+    ref, cand = (trace(e, seed, actions) for e in engines)
+    print("seed %d, %d actions: %s" % (seed, len(actions), actions or "(none)"))
+    print("first difference after step %d\n" % step)
+    missing = "(trace ended)"
+    left = render(ref[step]) if step < len(ref) else [missing]
+    right = render(cand[step]) if step < len(cand) else [missing]
+    print("%-20s %s" % names)
+    for i in range(max(len(left), len(right))):
+        a = left[i] if i < len(left) else ""
+        b = right[i] if i < len(right) else ""
+        print("%-20s %-20s %s" % (a, b, "<" if a != b else ""))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--reference", default="v2@HEAD")
+    parser.add_argument("--candidate", default="v2")
+    parser.add_argument("--seeds", type=int, default=200)
+    parser.add_argument("--steps", type=int, default=2000)
+    parser.add_argument("-D", dest="defines", action="append", default=[])
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as workdir:
+        try:
+            engines = [build(spec, workdir, args.defines) for spec in (args.reference, args.candidate)]
+        except subprocess.CalledProcessError as error:
+            sys.exit("engine build failed: %s" % " ".join(error.cmd))
+        for seed in range(1, args.seeds + 1):
+            rng = random.Random(seed)
+            actions = "".join(rng.choice(ACTIONS) for _ in range(args.steps))
+            if first_divergence(engines, seed, actions) is not None:
+                report((args.reference, args.candidate), engines, seed,
+                       shrink(engines, seed, actions))
+                sys.exit(1)
+        print("%s and %s agree on %d seeds x %d steps" %
+              (args.reference, args.candidate, args.seeds, args.steps))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,35 @@
+#!/usr/bin/env python3
+"""
+@file memory_monitor.py
+@author: JZimnol
+@brief Stack high-water mark reported by a MEMORY_ENABLE build (PACKET_MEMORY)
+
+usage: memory_monitor.py /dev/ttyUSB0 [baud]
+"""
+
+import struct
+import sys
+
+from telemetry import open_serial, packets
+
+SRAM_SIZE = 2048
+PACKET_MEMORY = ord("M")
+STATS = struct.Struct("<4H")    # MemoryStats
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit(__doc__)
+    baud = int(sys.argv[2]) if len(sys.argv) > 2 else 500000
+    print("%8s %8s %8s %8s" % ("static", "peak", "now", "free"))
+    for kind, payload in packets(open_serial(sys.argv[1], baud)):
+        if kind != PACKET_MEMORY or len(payload) != STATS.size:
+            continue
+        static, peak, free, now = STATS.unpack(payload)
+        print("%8d %8d %8d %8d   %5.1f%% of SRAM touched" %
+              (static, peak, now, free, 100.0 * (static + peak) / SRAM_SIZE))
+        sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
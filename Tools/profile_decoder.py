@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""
+@file profile_decoder.py
+@author: JZimnol
+@brief Live view of PACKET_PROFILE statistics streamed by a PROFILE_ENABLE build,
+       plus the PACKET_TASK timing of the scheduler tasks
+
+usage: profile_decoder.py /dev/ttyUSB0 [baud]
+"""
+
+import struct
+import sys
+
+from telemetry import open_serial, packets
+
+F_CPU = 8000000
+PROFILE_BUCKETS = 8
+PACKET_PROFILE = ord("P")
+PACKET_TASK = ord("T")
+STATS = struct.Struct("<BHHHI%dH" % PROFILE_BUCKETS)    # id + ProfileStats
+TASK = struct.Struct("<BIHHHHH")                        # id + TaskStats
+NAMES = ["refresh ISR", "moveBlockDown", "deleteLevel",
+         "rotateBlockRight", "updateFramebuffer", "updatePoints", "logic tick"]
+TASKS = ["input", "gravity", "animation", "render", "background", "telemetry"]
+TICK_MS = 0.512
+BAR_WIDTH = 30
+
+
+def bucket_label(bucket):
+    if bucket == 0:
+        return "      <256"
+    if bucket == PROFILE_BUCKETS - 1:
+        return ">=%8d" % (256 << (bucket - 1))
+    return "%5d-%-5d" % (256 << (bucket - 1), (256 << bucket) - 1)
+
+
+def render(table, tasks):
+    out = ["\x1b[H\x1b[2J%-18s %7s %6s %6s %8s %9s" %
+           ("region", "calls", "min", "max", "avg", "avg [us]")]
+    for ident in sorted(table):
+        calls, low, high, total, hist = table[ident]
+        name = NAMES[ident] if ident < len(NAMES) else "region %d" % ident
+        avg = total / calls if calls else 0
+        out.append("%-18s %7d %6d %6d %8.1f %9.1f" %
+                   (name, calls, low if calls else 0, high, avg, avg * 1e6 / F_CPU))
+        peak = max(hist) or 1
+        for bucket, count in enumerate(hist):
+            if count:
+                out.append("    %s |%-*s %d" % (bucket_label(bucket), BAR_WIDTH,
+                                                "#" * max(1, count * BAR_WIDTH // peak), count))
+    if tasks:
+        out.append("%-18s %7s %8s %7s %10s %9s %7s" %
+                   ("task", "runs", "overruns", "skipped", "late [ms]", "run [ms]", "dropped"))
+    for ident in sorted(tasks):
+        runs, overruns, skipped, lateness, duration, dropped = tasks[ident]
+        name = TASKS[ident] if ident < len(TASKS) else "task %d" % ident
+        out.append("%-18s %7d %8d %7d %10.1f %9.1f %7d" %
+                   (name, runs, overruns, skipped, lateness * TICK_MS, duration * TICK_MS, dropped))
+    sys.stdout.write("\n".join(out) + "\n")
+    sys.stdout.flush()
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit(__doc__)
+    baud = int(sys.argv[2]) if len(sys.argv) > 2 else 500000
+    table = {}
+    tasks = {}
+    for kind, payload in packets(open_serial(sys.argv[1], baud)):
+        if kind == PACKET_TASK and len(payload) == TASK.size:
+            fields = TASK.unpack(payload)
+            tasks[fields[0]] = fields[1:]
+        elif kind == PACKET_PROFILE and len(payload) == STATS.size:
+            fields = STATS.unpack(payload)
+            table[fields[0]] = (fields[1], fields[2], fields[3], fields[4], fields[5:])
+        else:
+            continue
+        render(table, tasks)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""
+@file remote_bot.py
+@author: JZimnol
+@brief Plays a REMOTE_ENABLE build over its serial port with random actions
+       and checks the board's input counters (RemoteStats)
+
+usage: remote_bot.py [-n actions] [-r per second] [-l ms] [-s seed] /dev/ttyUSB0 [baud]
+       -n  actions to send (default 1000)
+       -r  actions per second (default: as fast as the line goes)
+       -l  lead: actions are stamped to be applied this long after sending
+           (default 5 ms, keep it below 7 packet times)
+       -s  seed of the random actions (default 1)
+
+The board clock is taken from a status reply, and every action is stamped
+with the tick it should be applied at. At the end the counters are read
+again. The exit code is 1 when an action was lost, rejected or did not fit
+the queue, or when fewer actions were applied than sent. Actions that
+reach the board while the game is not played (splash, line clear
+animation, game over) are counted as ignored and fail the run too, so
+start a game first. Late actions are only reported, they show how well
+the host keeps its pace.
+"""
+
+import getopt
+import random
+import struct
+import sys
+import time
+
+from telemetry import frame, open_serial, packets
+
+PACKET_REMOTE_INPUT = ord("I")
+PACKET_REMOTE_STATUS = ord("S")
+STATS = struct.Struct("<8HB")   # RemoteStats
+COUNTERS = ("received", "applied", "ignored", "late", "overflows", "rejected", "lost")
+TICK_S = 0.000512
+PACKET_BITS = 8 * 10            # sync, type, length, 4 payload bytes, crc; 8N1
+
+# Input values; pause is left out, it would stop the game
+ACTIONS = [(1, 3), (2, 3), (4, 3), (3, 2), (7, 1)]     # (action, weight): left, right, rotate, down, drop
+
+
+def status(port):
+    """Ask for the counters; other packets (telemetry) are skipped."""
+    for _ in range(3):
+        port.write(frame(PACKET_REMOTE_STATUS))
+        for kind, payload in packets(port):
+            if kind == PACKET_REMOTE_STATUS and len(payload) == STATS.size:
+                return STATS.unpack(payload)
+    sys.exit("no status reply, is it a REMOTE_ENABLE build?")
+
+
+def main():
+    try:
+        opts, args = getopt.getopt(sys.argv[1:], "n:r:l:s:")
+    except getopt.GetoptError:
+        sys.exit(__doc__)
+    opts = dict(opts)
+    if not args:
+        sys.exit(__doc__)
+    count = int(opts.get("-n", 1000))
+    baud = int(args[1]) if len(args) > 1 else 38400
+    rate = float(opts.get("-r", baud / PACKET_BITS))
+    lead = float(opts.get("-l", 5)) / 1000
+    rng = random.Random(int(opts.get("-s", 1)))
+    port = open_serial(args[0], baud, write=True, timeout=0.5)
+
+    before = status(port)
+    start = time.monotonic()
+    actions, weights = zip(*ACTIONS)
+    for seq in range(count):
+        time.sleep(max(0, start + seq / rate - time.monotonic()))
+        at = (before[0] + round((time.monotonic() - start + lead) / TICK_S)) & 0xFFFF
+        action = rng.choices(actions, weights)[0]
+        port.write(frame(PACKET_REMOTE_INPUT, struct.pack("<BBH", seq & 0xFF, action, at)))
+    elapsed = time.monotonic() - start
+
+    # wait for the queue to drain
+    after = status(port)
+    while after[8]:
+        time.sleep(0.05)
+        after = status(port)
+
+    delta = {name: (after[i + 1] - before[i + 1]) & 0xFFFF for i, name in enumerate(COUNTERS)}
+    print("sent %d actions in %.2f s (%.0f per second)" % (count, elapsed, count / elapsed))
+    print("  ".join("%s %d" % (name, delta[name]) for name in COUNTERS))
+    failed = (delta["lost"] or delta["rejected"] or delta["overflows"] or
+              delta["received"] != count or delta["applied"] != count)
+    print("FAIL" if failed else "OK")
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
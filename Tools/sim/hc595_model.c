@@ -0,0 +1,138 @@
+/*
+ * @file hc595_model.c
+ * @author: JZimnol
+ * @brief File containing definitions for the 74HC595 chain and LED matrix model
+ */ 
+
+#include <stdio.h>
+#include <string.h>
+#include "hc595_model.h"
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+void modelInit(HC595Model *model) {
+    memset(model, 0, sizeof(*model));
+    model->lastRow = -1;
+}
+
+void modelShift(HC595Model *model, uint64_t cycle, uint8_t byte) {
+    if( model->shifted == 0 ) model->firstShift = cycle;
+    /* every byte pushes the older ones further down the chain, so after a
+       full transfer the first byte sent sits in the last register */
+    memmove(&model->shift[0], &model->shift[1], MODEL_CHAIN_BYTES - 1);
+    model->shift[MODEL_CHAIN_BYTES - 1] = byte;
+    if( model->shifted < 255 ) model->shifted++;
+}
+
+/* accumulate on-time of the currently latched pixels */
+static void integrate(HC595Model *model, uint64_t cycle) {
+    uint64_t span;
+
+    if( model->latches == 0 || cycle <= model->lastLatch ) return;
+    span = cycle - model->lastLatch;
+    for( int r=0; r<MODEL_ROWS; r++ ) {
+        if( !(model->rows & (0x80000000u >> r)) ) continue;
+        for( int c=0; c<MODEL_COLUMNS; c++ ) {
+            if( model->columns & (1ull << c) ) model->litCycles[r][c] += span;
+        }
+    }
+}
+
+void modelLatch(HC595Model *model, uint64_t cycle, const uint16_t *expected) {
+    uint32_t rows;
+    int row = -1;
+
+    integrate(model, cycle);
+    if( model->latches == 0 ) model->firstLatch = cycle;
+    model->latches++;
+    model->lastLatch = cycle;
+
+    if( model->shifted != MODEL_CHAIN_BYTES ) {
+        model->shortLatches++;
+    }
+    else {
+        uint64_t transfer = cycle - model->firstShift;
+        model->transfers++;
+        model->transferCycles += transfer;
+        if( transfer > model->transferMax ) model->transferMax = transfer;
+    }
+    model->shifted = 0;
+
+    /* the farthest panel is sent first; column drivers sink current, so a
+       zero bit lights the pixel */
+    model->columns = 0;
+    for( int p=0; p<MODEL_PANELS; p++ ) {
+        const uint8_t *word = &model->shift[2*(MODEL_PANELS - 1 - p)];
+        model->columns |= (uint64_t)(uint16_t)~((word[0]<<8) | word[1]) << (16*p);
+    }
+    rows = ((uint32_t)model->shift[2*MODEL_PANELS]<<24) | ((uint32_t)model->shift[2*MODEL_PANELS + 1]<<16) |
+           ((uint32_t)model->shift[2*MODEL_PANELS + 2]<<8) | model->shift[2*MODEL_PANELS + 3];
+    model->rows = rows;
+
+    if( rows & (rows - 1) ) model->multiRowLatches++;
+    for( int r=0; r<MODEL_ROWS; r++ ) {
+        if( rows & (0x80000000u >> r) ) {
+            row = r;
+            break;
+        }
+    }
+    if( row >= 0 && row <= model->lastRow ) model->frames++;
+    if( row >= 0 ) model->lastRow = row;
+
+    if( row >= 0 && expected != NULL && (uint16_t)model->columns != expected[row] ) {
+        model->staleLatches++;
+    }
+}
+
+void modelFlush(HC595Model *model, uint64_t cycle) {
+    integrate(model, cycle);
+    model->lastLatch = cycle;
+}
+
+void modelReport(const HC595Model *model, uint32_t frequency, double ghostRatio) {
+    uint64_t elapsed = model->lastLatch - model->firstLatch;
+    uint64_t brightest = 0;
+    unsigned ghosts = 0;
+
+    if( elapsed == 0 ) {
+        printf("no latch activity\n");
+        return;
+    }
+    for( int r=0; r<MODEL_ROWS; r++ ) {
+        for( int c=0; c<MODEL_COLUMNS; c++ ) {
+            if( model->litCycles[r][c] > brightest ) brightest = model->litCycles[r][c];
+        }
+    }
+
+    printf("duty cycle per pixel [%% of time], panel 0 on the right, its leftmost column = bit 15\n");
+    for( int r=0; r<MODEL_ROWS; r++ ) {
+        printf("%2d ", r);
+        for( int c=MODEL_COLUMNS - 1; c>=0; c-- ) {
+            uint64_t lit = model->litCycles[r][c];
+            if( lit == 0 ) {
+                printf("   . ");
+                continue;
+            }
+            if( lit < brightest * ghostRatio ) ghosts++;
+            printf("%4.1f%c", 100.0 * lit / elapsed,
+                   lit < brightest * ghostRatio ? '!' : ' ');
+        }
+        printf("\n");
+    }
+
+    printf("simulated time     : %.3f ms\n", 1e3 * elapsed / frequency);
+    printf("latches            : %llu (%.1f us per row)\n",
+           (unsigned long long)model->latches,
+           1e6 * elapsed / frequency / (model->latches ? model->latches : 1));
+    printf("refresh rate       : %.2f Hz\n", (double)model->frames * frequency / elapsed);
+    printf("ghost pixels (!)   : %u (lit < %.1f%% of brightest)\n", ghosts, 100.0 * ghostRatio);
+    printf("multi-row latches  : %llu\n", (unsigned long long)model->multiRowLatches);
+    printf("partial transfers  : %llu\n", (unsigned long long)model->shortLatches);
+    printf("stale row latches  : %llu\n", (unsigned long long)model->staleLatches);
+    printf("row transfer       : %d panel(s), %d bytes, avg %.1f us, max %.1f us\n",
+           MODEL_PANELS, MODEL_CHAIN_BYTES,
+           model->transfers ? 1e6 * model->transferCycles / model->transfers / frequency : 0.0,
+           1e6 * model->transferMax / frequency);
+}
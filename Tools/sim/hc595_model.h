@@ -0,0 +1,82 @@
+/*
+ * @file hc595_model.h
+ * @author: JZimnol
+ * @brief Software model of the 74HC595 chain and LED matrix of Tetris_v2.
+ *        It is fed with the raw SPI bytes and latch edges produced by the
+ *        firmware and integrates which pixels are lit over time.
+ */ 
+
+
+#ifndef HC595_MODEL_H_
+#define HC595_MODEL_H_
+
+#include <stdint.h>
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+
+#ifndef MODEL_PANELS
+    #define MODEL_PANELS    1     /* must match DISPLAY_PANELS of the firmware */
+#endif
+#define MODEL_ROWS          32
+#define MODEL_COLUMNS       (16*MODEL_PANELS)
+#define MODEL_CHAIN_BYTES   (2*MODEL_PANELS + 4)  /* column bytes + 4 row select bytes */
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief State of the register chain and accumulated statistics
+ */
+typedef struct {
+    uint8_t  shift[MODEL_CHAIN_BYTES];      /* shift stage, [0] = first byte sent */
+    uint8_t  shifted;                       /* bytes shifted since last latch */
+    uint64_t columns;                       /* latched columns, 1 = lit; bits 0-15 = panel 0 */
+    uint32_t rows;                          /* latched rows, bit 31 = row 0 */
+    uint64_t lastLatch;                     /* cycle of last latch edge */
+    uint64_t firstLatch;
+    uint64_t litCycles[MODEL_ROWS][MODEL_COLUMNS];
+
+    uint64_t latches;
+    uint64_t frames;                        /* scans that reached row 0 again */
+    uint64_t multiRowLatches;               /* more than one row driven at once */
+    uint64_t shortLatches;                  /* latch with != 6 bytes shifted */
+    uint64_t staleLatches;                  /* latched data != expected row */
+    uint64_t firstShift;                    /* cycle of first byte of the transfer */
+    uint64_t transferCycles;                /* first byte to latch, summed */
+    uint64_t transferMax;
+    uint64_t transfers;                     /* complete row transfers */
+    int      lastRow;
+} HC595Model;
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief reset model state and statistics
+ */
+void modelInit(HC595Model *model);
+/*
+ * @brief one byte has been shifted in by SPI
+ */
+void modelShift(HC595Model *model, uint64_t cycle, uint8_t byte);
+/*
+ * @brief rising edge of the latch line (LT_ON); the pixels lit by the
+ *        previous latch are integrated up to this cycle
+ * @param expected frame of panel 0 (copy of frameBuffer.main) or NULL if unknown
+ */
+void modelLatch(HC595Model *model, uint64_t cycle, const uint16_t *expected);
+/*
+ * @brief integrate lit pixels up to the given cycle (end of a run)
+ */
+void modelFlush(HC595Model *model, uint64_t cycle);
+/*
+ * @brief print duty cycle map, refresh rate and ghosting report
+ * @param pixels lit for less than ghostRatio of the brightest pixel
+ *        are reported as ghosts
+ */
+void modelReport(const HC595Model *model, uint32_t frequency, double ghostRatio);
+
+#endif /* HC595_MODEL_H_ */
@@ -0,0 +1,54 @@
+/*
+ * @file sim_board.c
+ * @author: JZimnol
+ * @brief File containing definitions for the helpers shared by the harnesses
+ */ 
+
+#include <stddef.h>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/sim_interrupts.h>
+#include <simavr/avr_ioport.h>
+#include "sim_board.h"
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+avr_t *boardLoad(const char *path) {
+    elf_firmware_t firmware = {{0}};
+    avr_t *avr;
+
+    if( elf_read_firmware(path, &firmware) != 0 ) return NULL;
+    avr = avr_make_mcu_by_name("atmega328p");
+    if( avr == NULL ) return NULL;
+    avr_init(avr);
+    avr->frequency = BOARD_FREQUENCY;
+    avr_load_firmware(avr, &firmware);
+    for( int pin=0; pin<BOARD_BUTTONS; pin++ ) boardSetButton(avr, pin, 0);
+    return avr;
+}
+
+void boardSetButton(avr_t *avr, int pin, int pushed) {
+    avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('C'), pin), !pushed);
+}
+
+void isrInit(IsrTracker *isr) {
+    isr->running = 0;
+    isr->vector = -1;
+    isr->entry = 0;
+}
+
+IsrEvent isrUpdate(IsrTracker *isr, avr_t *avr, uint64_t before) {
+    if( !isr->running && avr->interrupts.running_ptr > 0 ) {
+        isr->running = 1;
+        isr->vector = avr->interrupts.running[0]->vector;
+        isr->entry = before;
+        return ISR_ENTERED;
+    }
+    if( isr->running && avr->interrupts.running_ptr == 0 ) {
+        isr->running = 0;
+        return ISR_LEFT;
+    }
+    return ISR_NONE;
+}
@@ -0,0 +1,67 @@
+/*
+ * @file sim_board.h
+ * @author: JZimnol
+ * @brief Helpers shared by the simavr harnesses: an ATmega328p loaded with a
+ *        Tetris_v2 firmware image, its buttons and the interrupt being run
+ */ 
+
+
+#ifndef SIM_BOARD_H_
+#define SIM_BOARD_H_
+
+#include <stdint.h>
+#include <simavr/sim_avr.h>
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+
+#define BOARD_FREQUENCY     8000000 /* F_CPU of Tetris_v2 */
+#define BOARD_BUTTONS       4       /* PC0..PC3 */
+#define REFRESH_VECTOR      14      /* TIMER0_COMPA */
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Outermost interrupt being run; nested ones are part of its time
+ */
+typedef struct {
+    int running;                            /* inside an interrupt */
+    int vector;                             /* current or last vector */
+    uint64_t entry;                         /* cycle of the instruction it preempted */
+} IsrTracker;
+/*
+ * @brief Result of isrUpdate()
+ */
+typedef enum {
+    ISR_NONE,
+    ISR_ENTERED,                            /* vector and entry are the new interrupt */
+    ISR_LEFT                                /* vector and entry are the one that ended */
+} IsrEvent;
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+/*
+ * @brief load a firmware image into a new ATmega328p at BOARD_FREQUENCY,
+ *        with all buttons released
+ * @return the core, or NULL if the image or the core cannot be loaded
+ */
+avr_t *boardLoad(const char *path);
+/*
+ * @brief push or release a button; pins as sampled by Input.c (pushed = low)
+ */
+void boardSetButton(avr_t *avr, int pin, int pushed);
+/*
+ * @brief start outside of any interrupt
+ */
+void isrInit(IsrTracker *isr);
+/*
+ * @brief follow the outermost interrupt; call after every avr_run()
+ * @param cycle counter before that avr_run()
+ */
+IsrEvent isrUpdate(IsrTracker *isr, avr_t *avr, uint64_t before);
+
+#endif /* SIM_BOARD_H_ */
@@ -0,0 +1,101 @@
+/*
+ * @file sim_display.c
+ * @author: JZimnol
+ * @brief simavr harness feeding the 74HC595 model with the exact SPI bytes
+ *        and latch edges of a Tetris_v2 firmware image
+ *
+ * build: gcc -O2 -o sim_display sim_display.c hc595_model.c sim_board.c $(pkg-config --cflags --libs simavr) -lelf
+ *        (add -DMODEL_PANELS=N for a firmware built with DISPLAY_PANELS=N)
+ * usage: sim_display [-m ms] [-s ms] [-f addr] [-g ratio] firmware.elf
+ *        -m  simulated time to run (default 2000 ms)
+ *        -s  press the start button (PC1) at this time (default: never)
+ *        -f  data address of frameBuffer.main for stale row checks,
+ *            e.g. -f 0x$(avr-nm firmware.elf | awk '/ frameBuffer$/ {print $1}')
+ *        -g  ghost threshold relative to the brightest pixel (default 0.25)
+ */ 
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <simavr/sim_avr.h>
+#include <simavr/avr_spi.h>
+#include <simavr/avr_ioport.h>
+#include "hc595_model.h"
+#include "sim_board.h"
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static avr_t *avr;
+static HC595Model model;
+static long frameBufferAddr = -1;
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+static void spiHook(struct avr_irq_t *irq, uint32_t value, void *param) {
+    modelShift(&model, avr->cycle, value);
+}
+
+static void latchHook(struct avr_irq_t *irq, uint32_t value, void *param) {
+    uint16_t expected[MODEL_ROWS];
+
+    if( !value ) return;                     /* only LT_ON (rising edge) latches */
+    if( frameBufferAddr < 0 ) {
+        modelLatch(&model, avr->cycle, NULL);
+        return;
+    }
+    for( int r=0; r<MODEL_ROWS; r++ ) {
+        expected[r] = avr->data[frameBufferAddr + 2*r] | (avr->data[frameBufferAddr + 2*r + 1]<<8);
+    }
+    modelLatch(&model, avr->cycle, expected);
+}
+
+int main(int argc, char *argv[]) {
+    double runMs = 2000, startMs = -1, ghostRatio = 0.25;
+    int opt;
+
+    while( (opt = getopt(argc, argv, "m:s:f:g:")) != -1 ) {
+        switch (opt) {
+            case 'm': runMs = atof(optarg); break;
+            case 's': startMs = atof(optarg); break;
+            case 'f': frameBufferAddr = strtol(optarg, NULL, 0) & 0xffff; break;
+            case 'g': ghostRatio = atof(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-m ms] [-s ms] [-f addr] [-g ratio] firmware.elf\n", argv[0]);
+                return 1;
+        }
+    }
+    if( optind >= argc || (avr = boardLoad(argv[optind])) == NULL ) {
+        fprintf(stderr, "cannot load firmware\n");
+        return 1;
+    }
+
+    modelInit(&model);
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_SPI_GETIRQ(0), SPI_IRQ_OUTPUT), spiHook, NULL);
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('B'), 2), latchHook, NULL);
+
+    uint64_t end = avr_usec_to_cycles(avr, runMs * 1000);
+    uint64_t start = startMs < 0 ? 0 : avr_usec_to_cycles(avr, startMs * 1000);
+    uint64_t release = start + avr_usec_to_cycles(avr, 50000);
+    int pressed = 0;
+
+    while( avr->cycle < end ) {
+        int state = avr_run(avr);
+        if( state == cpu_Done || state == cpu_Crashed ) break;
+        if( startMs >= 0 && !pressed && avr->cycle >= start ) {
+            boardSetButton(avr, 1, 1);
+            pressed = 1;
+        }
+        if( pressed == 1 && avr->cycle >= release ) {
+            boardSetButton(avr, 1, 0);
+            pressed = 2;
+        }
+    }
+
+    modelFlush(&model, avr->cycle);
+    modelReport(&model, avr->frequency, ghostRatio);
+    return 0;
+}
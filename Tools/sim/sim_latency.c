@@ -0,0 +1,222 @@
+/*
+ * @file sim_latency.c
+ * @author: JZimnol
+ * @brief simavr harness measuring the button-to-photon latency of a Tetris_v2
+ *        firmware image: from a button edge on PINC to the first LT_ON latch
+ *        that puts a changed row on the LEDs
+ *
+ * build: gcc -O2 -o sim_latency sim_latency.c hc595_model.c sim_board.c $(pkg-config --cflags --libs simavr) -lelf
+ *        (add -DMODEL_PANELS=N for a firmware built with DISPLAY_PANELS=N)
+ * usage: sim_latency [-n presses] [-m ms] [-r seed] [-h ms] firmware.elf
+ *        -n  presses per action (default 100)
+ *        -m  simulated time limit (default 600000 ms)
+ *        -r  seed of the action and phase choice (default 1)
+ *        -h  how long a button is held (default 40 ms)
+ *
+ * Presses go in after a gravity step, once the display has been still for
+ * SETTLE_MS. The next fall is then more than TIMEOUT_MS away (at the low
+ * levels a random player reaches), so it cannot be taken for the answer to
+ * the button, and animations are not mistaken for the game. The press time
+ * is random within one scan frame, so every phase of the refresh relative
+ * to the edge is sampled. A press whose action changes nothing (a block at
+ * the wall, a rotated O) is counted but not timed. When the display stays
+ * still for IDLE_MS (splash, high score) rotate is pushed to start a game;
+ * these presses are not measured. Only the 74HC595 backend is supported;
+ * panel 0 is watched.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <simavr/sim_avr.h>
+#include <simavr/avr_spi.h>
+#include <simavr/avr_ioport.h>
+#include "hc595_model.h"
+#include "sim_board.h"
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+
+#define SETTLE_MS           300     /* display still for this long before a press, longer than a keyframe */
+#define TIMEOUT_MS          100     /* no change by then: the action did nothing */
+#define GAP_MS              170     /* press to press, longer than DEBOUNCE_TICKS */
+#define IDLE_MS             2000    /* no change at all: start a game */
+#define FRAME_CYCLES        (32 * 4096)     /* one scan of 32 rows at 8 MHz */
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Measured action; pins as sampled by Input.c
+ */
+typedef struct {
+    const char *name;
+    int pin;                        /* PCx, pushed = low */
+    uint64_t *samples;              /* latencies in cycles */
+    int count, unchanged;
+} Action;
+
+typedef enum {
+    WAIT_FALL,                      /* waiting for a gravity step */
+    WAIT_SETTLE,                    /* display must stay still */
+    WAIT_PRESS,                     /* press scheduled at a random phase */
+    WAIT_PHOTON                     /* pressed, waiting for a changed row */
+} Phase;
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static avr_t *avr;
+static HC595Model model;
+static Action actions[] = {
+    { .name = "left",   .pin = 2 },
+    { .name = "right",  .pin = 0 },
+    { .name = "rotate", .pin = 1 },
+    { .name = "down",   .pin = 3 }
+};
+#define ACTIONS ((int)(sizeof(actions) / sizeof(actions[0])))
+
+static uint16_t shown[MODEL_ROWS];          /* row as it is lit on the LEDs */
+static uint64_t lastChange;                 /* cycle of the last latch of a changed row */
+static uint64_t answerEnd;                  /* rest of the answer to a press is latched until then */
+static uint64_t pressCycle;
+static Phase phase = WAIT_FALL;
+static Action *current;
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+static void spiHook(struct avr_irq_t *irq, uint32_t value, void *param) {
+    modelShift(&model, avr->cycle, value);
+}
+
+static void latchHook(struct avr_irq_t *irq, uint32_t value, void *param) {
+    uint16_t columns;
+    int row;
+
+    if( !value ) return;                     /* only LT_ON (rising edge) latches */
+    modelLatch(&model, avr->cycle, NULL);
+    if( model.rows == 0 || (model.rows & (model.rows - 1)) ) return;
+    row = __builtin_clz(model.rows);         /* bit 31 = row 0 */
+    columns = (uint16_t)model.columns;       /* panel 0 */
+    if( columns == shown[row] ) return;
+    shown[row] = columns;
+    lastChange = avr->cycle;
+
+    if( phase == WAIT_PHOTON ) {
+        current->samples[current->count++] = avr->cycle - pressCycle;
+        answerEnd = avr->cycle + FRAME_CYCLES;
+        phase = WAIT_FALL;
+    }
+    /* the other rows of the answer are not a fall; a change while settling starts it again */
+    else if( phase != WAIT_FALL || avr->cycle > answerEnd ) phase = WAIT_SETTLE;
+}
+
+static int compare(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static double ms(uint64_t cycles) {
+    return cycles * 1000.0 / avr->frequency;
+}
+
+static void report(Action *action) {
+    uint64_t *s = action->samples;
+    uint64_t sum = 0;
+    int n = action->count;
+
+    if( n == 0 ) {
+        printf("%-6s     0 timed, %4d unchanged\n", action->name, action->unchanged);
+        return;
+    }
+    qsort(s, n, sizeof(uint64_t), compare);
+    for( int i=0; i<n; i++ ) sum += s[i];
+    printf("%-6s %5d timed, %4d unchanged: min %6.2f  p50 %6.2f  p99 %6.2f  max %6.2f  avg %6.2f ms\n",
+           action->name, n, action->unchanged, ms(s[0]), ms(s[(n - 1) * 50 / 100]),
+           ms(s[(n - 1) * 99 / 100]), ms(s[n - 1]), ms(sum / n));
+}
+
+int main(int argc, char *argv[]) {
+    double runMs = 600000, holdMs = 40;
+    int presses = 100, opt;
+    unsigned seed = 1;
+
+    while( (opt = getopt(argc, argv, "n:m:r:h:")) != -1 ) {
+        switch (opt) {
+            case 'n': presses = atoi(optarg); break;
+            case 'm': runMs = atof(optarg); break;
+            case 'r': seed = strtoul(optarg, NULL, 0); break;
+            case 'h': holdMs = atof(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-n presses] [-m ms] [-r seed] [-h ms] firmware.elf\n", argv[0]);
+                return 1;
+        }
+    }
+    if( presses < 1 || optind >= argc || (avr = boardLoad(argv[optind])) == NULL ) {
+        fprintf(stderr, "cannot load firmware\n");
+        return 1;
+    }
+    srand(seed);
+    for( int a=0; a<ACTIONS; a++ ) actions[a].samples = calloc(presses, sizeof(uint64_t));
+
+    modelInit(&model);
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_SPI_GETIRQ(0), SPI_IRQ_OUTPUT), spiHook, NULL);
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('B'), 2), latchHook, NULL);
+
+    uint64_t end = avr_usec_to_cycles(avr, runMs * 1000);
+    uint64_t settle = avr_usec_to_cycles(avr, SETTLE_MS * 1000);
+    uint64_t timeout = avr_usec_to_cycles(avr, TIMEOUT_MS * 1000);
+    uint64_t gap = avr_usec_to_cycles(avr, GAP_MS * 1000);
+    uint64_t idle = avr_usec_to_cycles(avr, IDLE_MS * 1000);
+    uint64_t hold = avr_usec_to_cycles(avr, holdMs * 1000);
+    uint64_t pressAt = 0, lastPress = 0, release = 0;
+    int heldPin = -1, starts = 0, done = 0;
+
+    while( avr->cycle < end && done < ACTIONS ) {
+        int state = avr_run(avr);
+        if( state == cpu_Done || state == cpu_Crashed ) break;
+
+        if( heldPin >= 0 && avr->cycle >= release ) {
+            boardSetButton(avr, heldPin, 0);
+            heldPin = -1;
+        }
+        if( phase == WAIT_PHOTON && avr->cycle - pressCycle > timeout ) {
+            current->unchanged++;
+            phase = WAIT_FALL;
+        }
+        if( heldPin >= 0 || avr->cycle - lastPress < gap ) continue;
+
+        if( phase != WAIT_PHOTON && avr->cycle - lastChange > idle ) {
+            /* splash or high score: rotate starts a game, not measured */
+            boardSetButton(avr, 1, 1);
+            heldPin = 1;
+            release = avr->cycle + hold;
+            lastPress = lastChange = avr->cycle;
+            phase = WAIT_FALL;
+            starts++;
+        }
+        else if( phase == WAIT_SETTLE && avr->cycle - lastChange >= settle ) {
+            do current = &actions[rand() % ACTIONS]; while( current->count >= presses );
+            pressAt = avr->cycle + (uint64_t)rand() % FRAME_CYCLES;
+            phase = WAIT_PRESS;
+        }
+        else if( phase == WAIT_PRESS && avr->cycle >= pressAt ) {
+            boardSetButton(avr, current->pin, 1);
+            heldPin = current->pin;
+            pressCycle = lastPress = avr->cycle;
+            release = avr->cycle + hold;
+            phase = WAIT_PHOTON;
+        }
+
+        done = 0;
+        for( int a=0; a<ACTIONS; a++ ) if( actions[a].count >= presses ) done++;
+    }
+
+    printf("button-to-photon latency after %.1f s, %d game starts\n", ms(avr->cycle) / 1000, starts);
+    for( int a=0; a<ACTIONS; a++ ) report(&actions[a]);
+    return 0;
+}
@@ -0,0 +1,158 @@
+/*
+ * @file sim_link.c
+ * @author: JZimnol
+ * @brief simavr harness running two VERSUS_ENABLE firmware images with their
+ *        USARTs cross-connected; measures the one-way latency of link frames
+ *
+ * build: gcc -O2 -o sim_link sim_link.c sim_board.c $(pkg-config --cflags --libs simavr) -lelf
+ * usage: sim_link [-m ms] firmware.elf [firmware_b.elf]
+ *        -m  simulated time to run (default 5000 ms)
+ *
+ * Both boards run in one process on the same cycle clock instead of two
+ * simulators joined by a pty pair, so host scheduling does not add jitter to
+ * the numbers. Latency is measured from the first byte of a frame leaving
+ * one board to the first byte of its ack leaving the other one, so it covers
+ * the line time, the RX interrupt and the main loop poll of the receiver.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <simavr/sim_avr.h>
+#include <simavr/avr_uart.h>
+#include "sim_board.h"
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+
+#define LINK_SYNC           0x7e
+#define LINK_FRAME_BYTES    5
+#define LINK_ACK            'A'
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Frames seen on the output of one board
+ */
+typedef struct {
+    avr_t   *avr;
+    uint8_t  frame[LINK_FRAME_BYTES];
+    int      index;
+    uint64_t frameStart;
+    uint64_t sentAt[256];       /* first transmission of every sequence number */
+    uint8_t  pending[256];
+    /* latency of frames sent by this board, acked by the other one */
+    uint64_t samples, total, min, max;
+    uint64_t retries;
+} Board;
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static Board boards[2];
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+static void frameDone(Board *self, Board *peer) {
+    uint8_t type = self->frame[1];
+    uint8_t seq = self->frame[2];
+
+    if( type == LINK_ACK ) {
+        /* ack of a frame sent by the peer */
+        if( !peer->pending[seq] ) return;
+        uint64_t latency = self->frameStart - peer->sentAt[seq];
+        peer->pending[seq] = 0;
+        peer->samples++;
+        peer->total += latency;
+        if( latency < peer->min ) peer->min = latency;
+        if( latency > peer->max ) peer->max = latency;
+        return;
+    }
+    if( self->pending[seq] ) {
+        self->retries++;
+        return;
+    }
+    self->pending[seq] = 1;
+    self->sentAt[seq] = self->frameStart;
+}
+
+static void uartHook(struct avr_irq_t *irq, uint32_t value, void *param) {
+    Board *self = param;
+    Board *peer = self == &boards[0] ? &boards[1] : &boards[0];
+
+    if( self->index == 0 ) {
+        if( value != LINK_SYNC ) return;
+        self->frameStart = self->avr->cycle;
+    }
+    self->frame[self->index++] = value;
+    if( self->index == LINK_FRAME_BYTES ) {
+        frameDone(self, peer);
+        self->index = 0;
+    }
+}
+
+static void report(const char *name, const Board *board) {
+    double us = 1e6 / board->avr->frequency;
+
+    if( board->samples == 0 ) {
+        printf("%s: no acked frames\n", name);
+        return;
+    }
+    printf("%s: %llu frames, latency min %.0f us, avg %.0f us, max %.0f us, %llu resent\n",
+           name, (unsigned long long)board->samples, board->min * us,
+           (double)board->total / board->samples * us, board->max * us,
+           (unsigned long long)board->retries);
+}
+
+int main(int argc, char *argv[]) {
+    double runMs = 5000;
+    int opt;
+
+    while( (opt = getopt(argc, argv, "m:")) != -1 ) {
+        switch (opt) {
+            case 'm': runMs = atof(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-m ms] firmware.elf [firmware_b.elf]\n", argv[0]);
+                return 1;
+        }
+    }
+    if( optind >= argc ) {
+        fprintf(stderr, "usage: %s [-m ms] firmware.elf [firmware_b.elf]\n", argv[0]);
+        return 1;
+    }
+    for( int i=0; i<2; i++ ) {
+        const char *path = optind + i < argc ? argv[optind + i] : argv[optind];
+        boards[i].avr = boardLoad(path);
+        boards[i].min = UINT64_MAX;
+        if( boards[i].avr == NULL ) {
+            fprintf(stderr, "cannot load %s\n", path);
+            return 1;
+        }
+    }
+
+    /* TX of each board drives RX of the other one */
+    for( int i=0; i<2; i++ ) {
+        avr_irq_t *out = avr_io_getirq(boards[i].avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT);
+        avr_irq_t *in = avr_io_getirq(boards[1 - i].avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT);
+        avr_connect_irq(out, in);
+        avr_irq_register_notify(out, uartHook, &boards[i]);
+    }
+
+    uint64_t end = avr_usec_to_cycles(boards[0].avr, runMs * 1000);
+    while( boards[0].avr->cycle < end ) {
+        /* lockstep: the board that is behind runs next */
+        avr_t *next = boards[0].avr->cycle <= boards[1].avr->cycle ? boards[0].avr : boards[1].avr;
+        int state = avr_run(next);
+        if( state == cpu_Done || state == cpu_Crashed ) break;
+    }
+
+    report("board A -> B", &boards[0]);
+    report("board B -> A", &boards[1]);
+    return 0;
+}
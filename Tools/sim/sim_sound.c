@@ -0,0 +1,177 @@
+/*
+ * @file sim_sound.c
+ * @author: JZimnol
+ * @brief simavr harness measuring the interrupt load of a Tetris_v2 firmware
+ *        image and the tones it plays on OC1A (PB1)
+ *
+ * build: gcc -O2 -o sim_sound sim_sound.c sim_board.c $(pkg-config --cflags --libs simavr) -lelf
+ * usage: sim_sound [-m ms] [-s ms] [-t cycles] [-n tones] firmware.elf
+ *        -m  simulated time to run (default 5000 ms)
+ *        -s  press the start button (PC1) at this time (default 100 ms)
+ *        -t  nominal refresh slot in cycles (default 4096, 0.512 ms at 8 MHz)
+ *        -n  tones to list (default 40)
+ *
+ * Run it on the same image with and without SOUND_ENABLE. The time spent in
+ * every interrupt vector is counted instruction by instruction, so the
+ * combined load and the worst refresh ISR can be compared. A refresh ISR that
+ * starts more than one slot after the previous one is counted as a late slot.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <simavr/sim_avr.h>
+#include <simavr/avr_ioport.h>
+#include "sim_board.h"
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+
+#define VECTORS             26      /* ATmega328p */
+#define TONE_TOLERANCE      0.02    /* periods within 2 % belong to one tone */
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Time spent in one interrupt vector
+ */
+typedef struct {
+    uint64_t count, cycles, worst;
+} VectorStats;
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static avr_t *avr;
+static VectorStats vectors[VECTORS];
+static uint64_t lateSlots, worstSpacing;
+/* tone being measured on PB1 */
+static uint64_t lastEdge, toneStart, tonePeriod, toneEdges;
+static int tonesListed, tonesMax = 40;
+static uint64_t tones;
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+static void toneDone() {
+    double hz, ms;
+
+    if( toneEdges < 2 ) return;
+    hz = (double)avr->frequency / tonePeriod;
+    ms = (lastEdge - toneStart) * 1000.0 / avr->frequency;
+    tones++;
+    if( tonesListed++ < tonesMax ) printf("tone %4.0f Hz %6.1f ms at %8.1f ms\n", hz, ms, toneStart * 1000.0 / avr->frequency);
+}
+
+static void pinHook(struct avr_irq_t *irq, uint32_t value, void *param) {
+    uint64_t period;
+
+    /* the timer drives the pin with AVR_IOPORT_OUTPUT set, bit 0 is the level */
+    if( !(value & 1) ) return;               /* rising edges only */
+    period = avr->cycle - lastEdge;
+    if( toneEdges > 0 && period > tonePeriod * (1 - TONE_TOLERANCE) && period < tonePeriod * (1 + TONE_TOLERANCE) ) {
+        toneEdges++;
+    }
+    else if( toneEdges == 1 || (toneEdges > 1 && period < tonePeriod * 4) ) {
+        /* second edge of a tone, or a new pitch right after the previous one */
+        toneDone();
+        toneStart = lastEdge;
+        tonePeriod = period;
+        toneEdges = 2;
+    }
+    else {
+        /* first edge after a rest */
+        toneDone();
+        toneStart = avr->cycle;
+        toneEdges = 1;
+    }
+    lastEdge = avr->cycle;
+}
+
+int main(int argc, char *argv[]) {
+    double runMs = 5000, startMs = 100;
+    uint64_t slot = 4096;
+    int opt;
+
+    while( (opt = getopt(argc, argv, "m:s:t:n:")) != -1 ) {
+        switch (opt) {
+            case 'm': runMs = atof(optarg); break;
+            case 's': startMs = atof(optarg); break;
+            case 't': slot = strtoull(optarg, NULL, 0); break;
+            case 'n': tonesMax = atoi(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-m ms] [-s ms] [-t cycles] [-n tones] firmware.elf\n", argv[0]);
+                return 1;
+        }
+    }
+    if( optind >= argc || (avr = boardLoad(argv[optind])) == NULL ) {
+        fprintf(stderr, "cannot load firmware\n");
+        return 1;
+    }
+
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('B'), 1), pinHook, NULL);
+
+    uint64_t end = avr_usec_to_cycles(avr, runMs * 1000);
+    uint64_t start = avr_usec_to_cycles(avr, startMs * 1000);
+    uint64_t release = start + avr_usec_to_cycles(avr, 50000);
+    uint64_t lastRefresh = 0;
+    IsrTracker isr;
+    int pressed = 0;
+
+    isrInit(&isr);
+
+    while( avr->cycle < end ) {
+        uint64_t before = avr->cycle;
+        int state = avr_run(avr);
+        if( state == cpu_Done || state == cpu_Crashed ) break;
+
+        switch (isrUpdate(&isr, avr, before)) {
+            case ISR_ENTERED:
+                if( isr.vector == REFRESH_VECTOR ) {
+                    if( lastRefresh && isr.entry - lastRefresh > worstSpacing ) worstSpacing = isr.entry - lastRefresh;
+                    if( lastRefresh && isr.entry - lastRefresh > slot + slot / 2 ) lateSlots++;
+                    lastRefresh = isr.entry;
+                }
+                break;
+            case ISR_LEFT: {
+                VectorStats *stats = &vectors[isr.vector < VECTORS ? isr.vector : 0];
+                uint64_t cycles = avr->cycle - isr.entry;
+                stats->count++;
+                stats->cycles += cycles;
+                if( cycles > stats->worst ) stats->worst = cycles;
+                break;
+            }
+            default:
+                break;
+        }
+
+        if( !pressed && avr->cycle >= start ) {
+            boardSetButton(avr, 1, 1);
+            pressed = 1;
+        }
+        if( pressed == 1 && avr->cycle >= release ) {
+            boardSetButton(avr, 1, 0);
+            pressed = 2;
+        }
+    }
+    toneDone();
+
+    uint64_t total = 0;
+    printf("\n%llu tones (%d listed)\n", (unsigned long long)tones, tonesListed < tonesMax ? tonesListed : tonesMax);
+    for( int v=0; v<VECTORS; v++ ) {
+        if( vectors[v].count == 0 ) continue;
+        total += vectors[v].cycles;
+        printf("vector %2d: %8llu runs, avg %5.1f cycles, worst %5llu cycles, load %5.2f %%\n", v,
+               (unsigned long long)vectors[v].count, (double)vectors[v].cycles / vectors[v].count,
+               (unsigned long long)vectors[v].worst, 100.0 * vectors[v].cycles / avr->cycle);
+    }
+    printf("combined interrupt load %.2f %%\n", 100.0 * total / avr->cycle);
+    printf("refresh: worst ISR %llu of %llu cycles, worst spacing %llu cycles, %llu late slots\n",
+           (unsigned long long)vectors[REFRESH_VECTOR].worst, (unsigned long long)slot,
+           (unsigned long long)worstSpacing, (unsigned long long)lateSlots);
+    return 0;
+}
@@ -0,0 +1,233 @@
+/*
+ * @file sim_trace.c
+ * @author: JZimnol
+ * @brief simavr harness writing a Chrome trace (JSON) of a Tetris_v2 firmware
+ *        image: every interrupt and every call of the selected functions as
+ *        a slice, to be opened in ui.perfetto.dev or chrome://tracing
+ *
+ * build: gcc -O2 -o sim_trace sim_trace.c sim_board.c $(pkg-config --cflags --libs simavr) -lelf
+ * usage: avr-nm firmware.elf > firmware.sym
+ *        sim_trace [-m ms] [-p ms] [-r seed] [-f names | -a] [-o file] firmware.elf firmware.sym
+ *        -m  simulated time to run (default 30000 ms)
+ *        -p  push a random button every this many ms (default 250, 0: only start)
+ *        -r  seed of the button choice (default 1)
+ *        -f  comma separated functions to trace (default: the engine functions)
+ *        -a  trace every function in the symbol file
+ *        -o  output file (default trace.json)
+ *
+ * The refresh ISR and the other vectors go to the "interrupts" track, the
+ * functions to the "main" track, so a slice of deleteLevel() shows the ISRs
+ * that preempted it right above it. A function is entered when the PC
+ * reaches its address and left when the stack pointer rises above its value
+ * at entry, which also closes the frames skipped by a longjmp. Time stamps
+ * are in microseconds of simulated time. Tracing every function of a whole
+ * game gives files of hundreds of MB, so pick the functions or shorten -m.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <simavr/sim_avr.h>
+#include "sim_board.h"
+
+/*************************************************************************\
+                                DEFINITIONS
+\*************************************************************************/
+
+#define FLASH_WORDS         16384   /* ATmega328p */
+#define MAX_NAMES           512
+#define MAX_DEPTH           32
+#define TRACK_MAIN          1
+#define TRACK_INTERRUPTS    2
+
+static const char defaultNames[] =
+    "moveBlockDown,moveBlockLeft,moveBlockRight,rotateBlockRight,holdBlock,"
+    "deleteLevel,updateFramebuffer,newGame,gameEvent,animationStep,bitmapDraw";
+
+/*************************************************************************\
+                              ENUMS AND STRUCTS
+\*************************************************************************/
+/*
+ * @brief Function being run on the main track
+ */
+typedef struct {
+    int name;                       /* index in names */
+    uint16_t sp;                    /* stack pointer right after the call */
+} Frame;
+
+/*************************************************************************\
+                                 VARIABLES
+\*************************************************************************/
+
+static avr_t *avr;
+static FILE *out;
+static char *names[MAX_NAMES];
+static int nameCount;
+static int16_t functionAt[FLASH_WORDS];     /* name index + 1 of the function at a word address */
+static Frame stack[MAX_DEPTH];
+static int depth;
+static uint64_t events;
+
+/*************************************************************************\
+                                 FUNCTIONS
+\*************************************************************************/
+
+static void emit(const char *name, char ph, int track) {
+    fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d%s}",
+            events++ ? ",\n" : "", name, ph, avr->cycle * 1e6 / avr->frequency, track,
+            ph == 'i' ? ",\"s\":\"g\"" : "");
+}
+
+static void emitTrackName(int track, const char *name) {
+    fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+            events++ ? ",\n" : "", track, name);
+}
+
+static int selected(const char *name, const char *list) {
+    size_t length = strlen(name);
+
+    if( list == NULL ) return strncmp(name, "__", 2) != 0;     /* -a: not the runtime */
+    for( const char *p = list; *p; ) {
+        const char *comma = strchr(p, ',');
+        size_t n = comma ? (size_t)(comma - p) : strlen(p);
+        if( n == length && strncmp(p, name, n) == 0 ) return 1;
+        p += n + (comma != NULL);
+    }
+    return 0;
+}
+
+/* avr-nm lines: address, type, name; only text symbols are used */
+static int loadSymbols(const char *path, const char *list) {
+    char line[256], type, name[200];
+    unsigned long address;
+    FILE *f = fopen(path, "r");
+
+    if( f == NULL ) return -1;
+    while( fgets(line, sizeof(line), f) ) {
+        if( sscanf(line, "%lx %c %199s", &address, &type, name) != 3 ) continue;
+        if( type != 'T' && type != 't' ) continue;
+        if( address / 2 >= FLASH_WORDS || functionAt[address / 2] ) continue;
+        if( nameCount == MAX_NAMES || !selected(name, list) ) continue;
+        names[nameCount++] = strdup(name);
+        functionAt[address / 2] = nameCount;
+    }
+    fclose(f);
+    return nameCount;
+}
+
+static uint16_t stackPointer() {
+    return avr->data[R_SPL] | (avr->data[R_SPH] << 8);
+}
+
+/* main track only: entries at a function address, exits when the stack rises */
+static void traceFunctions() {
+    uint16_t sp = stackPointer();
+    int entered;
+
+    while( depth > 0 && sp > stack[depth - 1].sp ) {
+        depth--;
+        emit(names[stack[depth].name], 'E', TRACK_MAIN);
+    }
+    entered = functionAt[(avr->pc / 2) % FLASH_WORDS];
+    /* a loop back to the first instruction is not a new call */
+    if( entered && depth > 0 && stack[depth - 1].name == entered - 1 && stack[depth - 1].sp == sp ) return;
+    if( entered && depth < MAX_DEPTH ) {
+        stack[depth].name = entered - 1;
+        stack[depth].sp = sp;
+        depth++;
+        emit(names[entered - 1], 'B', TRACK_MAIN);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    static const char *buttons[] = { "right", "rotate", "left", "down" };   /* PC0..PC3 */
+    const char *list = defaultNames, *outPath = "trace.json";
+    double runMs = 30000, pushMs = 250;
+    unsigned seed = 1;
+    char vectorName[32];
+    int opt;
+
+    while( (opt = getopt(argc, argv, "m:p:r:f:ao:")) != -1 ) {
+        switch (opt) {
+            case 'm': runMs = atof(optarg); break;
+            case 'p': pushMs = atof(optarg); break;
+            case 'r': seed = strtoul(optarg, NULL, 0); break;
+            case 'f': list = optarg; break;
+            case 'a': list = NULL; break;
+            case 'o': outPath = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-m ms] [-p ms] [-r seed] [-f names | -a] [-o file] firmware.elf firmware.sym\n", argv[0]);
+                return 1;
+        }
+    }
+    if( optind + 1 >= argc || (avr = boardLoad(argv[optind])) == NULL ) {
+        fprintf(stderr, "cannot load firmware\n");
+        return 1;
+    }
+    if( loadSymbols(argv[optind + 1], list) <= 0 ) {
+        fprintf(stderr, "no functions to trace in %s\n", argv[optind + 1]);
+        return 1;
+    }
+    out = fopen(outPath, "w");
+    if( out == NULL ) {
+        perror(outPath);
+        return 1;
+    }
+    srand(seed);
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    emitTrackName(TRACK_MAIN, "main");
+    emitTrackName(TRACK_INTERRUPTS, "interrupts");
+
+    uint64_t end = avr_usec_to_cycles(avr, runMs * 1000);
+    uint64_t push = avr_usec_to_cycles(avr, 100000);        /* start button at 100 ms */
+    uint64_t hold = avr_usec_to_cycles(avr, 50000);
+    uint64_t period = avr_usec_to_cycles(avr, pushMs * 1000);
+    uint64_t release = 0;
+    IsrTracker isr;
+    int pin = 1, held = 0;
+
+    isrInit(&isr);
+    while( avr->cycle < end ) {
+        uint64_t before = avr->cycle;
+        int state = avr_run(avr);
+        if( state == cpu_Done || state == cpu_Crashed ) break;
+
+        /* outermost interrupt only, nested ones are part of its slice */
+        switch (isrUpdate(&isr, avr, before)) {
+            case ISR_ENTERED:
+                if( isr.vector == REFRESH_VECTOR ) strcpy(vectorName, "refresh ISR");
+                else snprintf(vectorName, sizeof(vectorName), "vector %d", isr.vector);
+                emit(vectorName, 'B', TRACK_INTERRUPTS);
+                break;
+            case ISR_LEFT:
+                emit(vectorName, 'E', TRACK_INTERRUPTS);
+                break;
+            default:
+                break;
+        }
+        if( !isr.running ) traceFunctions();
+
+        if( !held && push && avr->cycle >= push ) {
+            boardSetButton(avr, pin, 1);
+            emit(buttons[pin], 'i', TRACK_MAIN);
+            release = avr->cycle + hold;
+            held = 1;
+        }
+        if( held && avr->cycle >= release ) {
+            boardSetButton(avr, pin, 0);
+            held = 0;
+            pin = rand() % 4;
+            push = period ? avr->cycle + period - hold : 0;
+        }
+    }
+
+    if( isr.running ) emit(vectorName, 'E', TRACK_INTERRUPTS);
+    while( depth > 0 ) emit(names[stack[--depth].name], 'E', TRACK_MAIN);
+    fprintf(out, "\n]}\n");
+    fclose(out);
+    printf("%llu events, %.1f ms simulated, %d functions traced, written to %s\n",
+           (unsigned long long)events, avr->cycle * 1e3 / avr->frequency, nameCount, outPath);
+    return 0;
+}
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""
+@file sram_report.py
+@author: JZimnol
+@brief SRAM usage of a firmware image against the budget set in Config.h
+
+usage: sram_report.py Tetris.elf [path/to/Config.h] [--top N]
+
+Static data (.data, .bss, .noinit) is read with avr-size, the largest
+variables with avr-nm. The stack gets everything that is left; the report
+fails (exit code 1) when less than SRAM_STACK_RESERVE bytes remain.
+"""
+
+import os
+import re
+import subprocess
+import sys
+
+STATIC_SECTIONS = (".data", ".bss", ".noinit")
+DEFAULT_CONFIG = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                              "..", "Tetris_v2", "Config.h")
+
+
+def config_value(path, name):
+    with open(path) as config:
+        match = re.search(r"#define\s+%s\s+(\d+)" % name, config.read())
+    if match is None:
+        sys.exit("%s: %s is not defined" % (path, name))
+    return int(match.group(1))
+
+
+def section_sizes(elf):
+    out = subprocess.run(["avr-size", "-A", elf], check=True,
+                         capture_output=True, text=True).stdout
+    sizes = {}
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[0] in STATIC_SECTIONS:
+            sizes[fields[0]] = int(fields[1])
+    return sizes
+
+
+def largest_symbols(elf, count):
+    out = subprocess.run(["avr-nm", "--size-sort", "-S", "-r", elf], check=True,
+                         capture_output=True, text=True).stdout
+    symbols = []
+    for line in out.splitlines():
+        fields = line.split()
+        # data symbols: b/B (.bss), d/D (.data)
+        if len(fields) == 4 and fields[2] in "bBdD":
+            symbols.append((int(fields[1], 16), fields[3]))
+    return symbols[:count]
+
+
+def main():
+    args = sys.argv[1:]
+    top = 10
+    if "--top" in args:
+        index = args.index("--top")
+        top = int(args[index + 1])
+        del args[index:index + 2]
+    if not args:
+        sys.exit(__doc__)
+    elf = args[0]
+    config = args[1] if len(args) > 1 else DEFAULT_CONFIG
+
+    sram = config_value(config, "SRAM_SIZE")
+    reserve = config_value(config, "SRAM_STACK_RESERVE")
+    sizes = section_sizes(elf)
+    used = sum(sizes.values())
+    headroom = sram - used - reserve
+
+    for name in STATIC_SECTIONS:
+        print("%-8s %5d" % (name, sizes.get(name, 0)))
+    print("%-8s %5d / %d bytes (%.1f%%)" % ("static", used, sram, 100.0 * used / sram))
+    print("%-8s %5d bytes reserved" % ("stack", reserve))
+    print("%-8s %5d bytes" % ("headroom", headroom))
+    print("\nlargest variables:")
+    for size, name in largest_symbols(elf, top):
+        print("  %5d  %s" % (size, name))
+
+    if headroom < 0:
+        print("\nSRAM budget exceeded by %d bytes" % -headroom, file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
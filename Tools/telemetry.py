@@ -0,0 +1,86 @@
+"""
+@file telemetry.py
+@author: JZimnol
+@brief Host side reader of framed packets sent by Tetris_v2/Telemetry.c
+
+Packet layout: SYNC | type | length | payload[length] | CRC-8 (type, length, payload)
+"""
+
+import os
+import sys
+import termios
+
+TELEMETRY_SYNC = 0x7E
+
+BAUD_RATES = {
+    38400: termios.B38400,
+    115200: termios.B115200,
+    230400: termios.B230400,
+    500000: getattr(termios, "B500000", None),
+    1000000: getattr(termios, "B1000000", None),
+}
+
+
+def crc8_ccitt(crc, data):
+    """Same polynomial (0x07) as _crc8_ccitt_update() from avr-libc."""
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def open_serial(path, baud=500000, write=False, timeout=None):
+    """Open a tty in raw mode, or a plain file / pipe with a recorded stream.
+
+    With a timeout (seconds) a read returns nothing when the line is quiet
+    that long, which ends packets().
+    """
+    fd = os.open(path, (os.O_RDWR if write else os.O_RDONLY) | os.O_NOCTTY)
+    if os.isatty(fd):
+        speed = BAUD_RATES.get(baud)
+        if speed is None:
+            sys.exit("unsupported baud rate: %d" % baud)
+        attrs = termios.tcgetattr(fd)
+        attrs[0] = 0                                          # iflag
+        attrs[1] = 0                                          # oflag
+        attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+        attrs[3] = 0                                          # lflag
+        attrs[4] = attrs[5] = speed
+        attrs[6][termios.VMIN] = 1 if timeout is None else 0
+        attrs[6][termios.VTIME] = 0 if timeout is None else min(255, int(timeout * 10))
+        termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return os.fdopen(fd, "r+b" if write else "rb", buffering=0)
+
+
+def frame(kind, payload=b""):
+    """Build one packet, e.g. for the remote input of a REMOTE_ENABLE build."""
+    body = bytes([kind, len(payload)]) + bytes(payload)
+    return bytes([TELEMETRY_SYNC]) + body + bytes([crc8_ccitt(0, body)])
+
+
+def packets(stream):
+    """Yield (type, payload) tuples; corrupted packets are skipped."""
+    buf = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            return
+        buf += chunk
+        while True:
+            start = buf.find(TELEMETRY_SYNC)
+            if start < 0:
+                buf.clear()
+                break
+            del buf[:start]
+            if len(buf) < 3:
+                break
+            length = buf[2]
+            if len(buf) < length + 4:
+                break
+            body = bytes(buf[1:3 + length])
+            if crc8_ccitt(0, body) != buf[3 + length]:
+                del buf[0]                   # false sync, search again
+                continue
+            del buf[:4 + length]
+            yield body[0], body[2:]